@@ -2,13 +2,260 @@
 
 #include "GridManager.h"
 #include "RobotMovementComponent.h"
+#include "RobotRallyGameState.h"
+#include "Engine/World.h"
 #include "Engine/StaticMesh.h"
-#include "Materials/MaterialInstanceDynamic.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "RallyMaterialLibrary.h"
+#include "Hash/CityHash.h"
 
-#if WITH_EDITORONLY_DATA
-#include "Materials/Material.h"
-#include "Materials/MaterialExpressionVectorParameter.h"
-#endif
+// FTileGrid
+
+void FTileGrid::Init(int32 InWidth, int32 InHeight)
+{
+	Width = FMath::Clamp(InWidth, 0, static_cast<int32>(MAX_uint16));
+	Height = FMath::Clamp(InHeight, 0, static_cast<int32>(MAX_uint16));
+	if (static_cast<int64>(Width) * Height > MaxTiles)
+	{
+		Height = MaxTiles / Width;
+		UE_LOG(LogTemp, Error, TEXT("Board %dx%d exceeds %d tiles, clamped to %dx%d"),
+			InWidth, InHeight, MaxTiles, Width, Height);
+	}
+	Tiles.Reset();
+	Tiles.SetNum(Width * Height);
+	ConveyorLinks.Reset();
+	ConveyorLinks.SetNum(Width * Height);
+	CheckpointTiles.Reset();
+	NumCheckpoints = 0;
+}
+
+void FTileGrid::SetTile(int32 X, int32 Y, const FPackedTile& NewTile)
+{
+	FPackedTile* Tile = Find(X, Y);
+	if (!Tile) return;
+
+	const int32 Index = ToIndex(X, Y);
+
+	// Drop the old checkpoint entry
+	if (Tile->TileType == ETileType::Checkpoint)
+	{
+		NumCheckpoints--;
+
+		const int32 OldNumber = Tile->CheckpointNumber;
+		if (FindCheckpoint(OldNumber) == Index)
+		{
+			CheckpointTiles[OldNumber] = INDEX_NONE;
+
+			// Fall back to another tile carrying the same number, if any
+			for (int32 i = 0; i < Tiles.Num(); ++i)
+			{
+				if (i != Index && Tiles[i].TileType == ETileType::Checkpoint && Tiles[i].CheckpointNumber == OldNumber)
+				{
+					CheckpointTiles[OldNumber] = i;
+					break;
+				}
+			}
+		}
+	}
+
+	*Tile = NewTile;
+
+	if (NewTile.TileType == ETileType::Checkpoint)
+	{
+		NumCheckpoints++;
+
+		const int32 Number = NewTile.CheckpointNumber;
+		if (CheckpointTiles.Num() <= Number)
+		{
+			const int32 OldNum = CheckpointTiles.Num();
+			CheckpointTiles.SetNumUninitialized(Number + 1);
+			for (int32 i = OldNum; i <= Number; ++i)
+			{
+				CheckpointTiles[i] = INDEX_NONE;
+			}
+		}
+		CheckpointTiles[Number] = Index;
+	}
+
+	UpdateConveyorLinksAround(X, Y);
+}
+
+bool FTileGrid::IsMovementBlocked(int32 FromX, int32 FromY, int32 ToX, int32 ToY) const
+{
+	const int32 DX = ToX - FromX;
+	const int32 DY = ToY - FromY;
+
+	// Not adjacent tiles - no wall blocking (diagonal/invalid movement)
+	if (FMath::Abs(DX) + FMath::Abs(DY) != 1)
+	{
+		return false;
+	}
+
+	// +X=North, +Y=East, -X=South, -Y=West
+	const EGridDirection Direction =
+		DX == 1  ? EGridDirection::North :
+		DX == -1 ? EGridDirection::South :
+		DY == 1  ? EGridDirection::East  : EGridDirection::West;
+
+	// Wall on the from-tile side, or on the to-tile side (opposite direction)
+	const EGridDirection Opposite = static_cast<EGridDirection>((static_cast<uint8>(Direction) + 2) % 4);
+	return HasWall(FromX, FromY, WallFlag(Direction)) || HasWall(ToX, ToY, WallFlag(Opposite));
+}
+
+int32 FTileGrid::GetConveyorDirection(ETileType Type)
+{
+	switch (Type)
+	{
+	case ETileType::ConveyorNorth: return 0;
+	case ETileType::ConveyorEast:  return 1;
+	case ETileType::ConveyorSouth: return 2;
+	case ETileType::ConveyorWest:  return 3;
+	default:                       return -1;
+	}
+}
+
+void FTileGrid::UpdateConveyorLink(int32 X, int32 Y)
+{
+	const int32 Index = ToIndex(X, Y);
+	FConveyorLink& Link = ConveyorLinks[Index];
+	Link = FConveyorLink();
+
+	const int32 Dir = GetConveyorDirection(Tiles[Index].TileType);
+	if (Dir < 0) return;
+
+	// +X=North, +Y=East, -X=South, -Y=West
+	static constexpr int32 DeltaX[4] = { 1, 0, -1, 0 };
+	static constexpr int32 DeltaY[4] = { 0, 1, 0, -1 };
+	const int32 NextX = X + DeltaX[Dir];
+	const int32 NextY = Y + DeltaY[Dir];
+
+	if (IsMovementBlocked(X, Y, NextX, NextY))
+	{
+		Link.bWallBlocked = true;
+		return;
+	}
+
+	// Conveyors never carry robots off the board; a pit at the end of a belt is fair game
+	const FPackedTile* Next = Find(NextX, NextY);
+	if (!Next) return;
+
+	Link.NextIndex = ToIndex(NextX, NextY);
+
+	// Arriving on a belt that bends rotates the robot with it
+	const int32 NextDir = GetConveyorDirection(Next->TileType);
+	if (NextDir >= 0)
+	{
+		const int32 Turn = (NextDir - Dir + 4) % 4;
+		Link.Rotation = (Turn == 1) ? 1 : (Turn == 3) ? -1 : 0;
+	}
+}
+
+void FTileGrid::UpdateConveyorLinksAround(int32 X, int32 Y)
+{
+	if (ConveyorLinks.Num() != Tiles.Num()) return;
+
+	static constexpr int32 OffsetX[5] = { 0, 1, 0, -1, 0 };
+	static constexpr int32 OffsetY[5] = { 0, 0, 1, 0, -1 };
+	for (int32 i = 0; i < 5; ++i)
+	{
+		if (IsInBounds(X + OffsetX[i], Y + OffsetY[i]))
+		{
+			UpdateConveyorLink(X + OffsetX[i], Y + OffsetY[i]);
+		}
+	}
+}
+
+void FTileGrid::RebuildConveyorLinks()
+{
+	ConveyorLinks.SetNum(Tiles.Num());
+	for (int32 y = 0; y < Height; ++y)
+	{
+		for (int32 x = 0; x < Width; ++x)
+		{
+			UpdateConveyorLink(x, y);
+		}
+	}
+}
+
+FPackedTile FTileGrid::Pack(const FTileData& Data)
+{
+	FPackedTile Tile;
+	Tile.TileType = Data.TileType;
+	Tile.CheckpointNumber = static_cast<uint8>(FMath::Clamp(Data.CheckpointNumber, 0, 255));
+	Tile.Walls = Data.Walls;
+	return Tile;
+}
+
+FTileData FTileGrid::Unpack(const FPackedTile& Tile)
+{
+	FTileData Data;
+	Data.TileType = Tile.TileType;
+	Data.CheckpointNumber = Tile.CheckpointNumber;
+	Data.Walls = Tile.Walls;
+	return Data;
+}
+
+void FTileGrid::WriteBoardBlob(TArray<uint8>& OutBlob) const
+{
+	OutBlob.Reset(4 + Tiles.Num() * 3);
+	OutBlob.Add(static_cast<uint8>(Width & 0xFF));
+	OutBlob.Add(static_cast<uint8>(Width >> 8));
+	OutBlob.Add(static_cast<uint8>(Height & 0xFF));
+	OutBlob.Add(static_cast<uint8>(Height >> 8));
+
+	for (const FPackedTile& Tile : Tiles)
+	{
+		OutBlob.Add(static_cast<uint8>(Tile.TileType));
+		OutBlob.Add(Tile.Walls);
+		OutBlob.Add(Tile.CheckpointNumber);
+	}
+}
+
+bool FTileGrid::ReadBoardBlob(TConstArrayView<uint8> Blob, int32& OutWidth, int32& OutHeight, TArray<FPackedTile>& OutTiles)
+{
+	if (Blob.Num() < 4) return false;
+
+	OutWidth = Blob[0] | (Blob[1] << 8);
+	OutHeight = Blob[2] | (Blob[3] << 8);
+
+	const int32 NumTiles = OutWidth * OutHeight;
+	if (NumTiles > MaxTiles || Blob.Num() != 4 + NumTiles * 3) return false;
+
+	OutTiles.SetNum(NumTiles);
+	for (int32 Index = 0; Index < NumTiles; ++Index)
+	{
+		const uint8* Bytes = Blob.GetData() + 4 + Index * 3;
+		if (Bytes[0] > static_cast<uint8>(ETileType::Checkpoint)) return false;
+
+		OutTiles[Index].TileType = static_cast<ETileType>(Bytes[0]);
+		OutTiles[Index].Walls = Bytes[1];
+		OutTiles[Index].CheckpointNumber = Bytes[2];
+	}
+	return true;
+}
+
+bool FTileGrid::InitFromBoardBlob(TConstArrayView<uint8> Blob)
+{
+	int32 BlobWidth = 0;
+	int32 BlobHeight = 0;
+	TArray<FPackedTile> BlobTiles;
+	if (!ReadBoardBlob(Blob, BlobWidth, BlobHeight, BlobTiles)) return false;
+
+	Init(BlobWidth, BlobHeight);
+	for (int32 Index = 0; Index < BlobTiles.Num(); ++Index)
+	{
+		const FIntVector Coords = FromIndex(Index);
+		SetTile(Coords.X, Coords.Y, BlobTiles[Index]);
+	}
+	return true;
+}
+
+uint64 FTileGrid::HashBoardBlob(TConstArrayView<uint8> Blob)
+{
+	return CityHash64(reinterpret_cast<const char*>(Blob.GetData()), Blob.Num());
+}
+
+// AGridManager
 
 AGridManager::AGridManager()
 {
@@ -42,8 +289,28 @@ AGridManager::AGridManager()
 void AGridManager::BeginPlay()
 {
 	Super::BeginPlay();
-	CreateBaseMaterial();
+
+	bBuildVisuals = !IsNetMode(NM_DedicatedServer);
+	if (bBuildVisuals)
+	{
+		CachedBaseMaterial = FRallyMaterialLibrary::GetBaseMaterial();
+	}
 	InitializeGrid();
+
+	// Nothing on the board actor changes after setup; edits flush dormancy explicitly
+	if (HasAuthority())
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+
+	// Clients: apply board state that replicated before this actor was ready
+	if (!HasAuthority())
+	{
+		if (ARobotRallyGameState* GS = GetWorld()->GetGameState<ARobotRallyGameState>())
+		{
+			GS->ApplyReplicatedTiles(this);
+		}
+	}
 }
 
 void AGridManager::Tick(float DeltaTime)
@@ -51,37 +318,12 @@ void AGridManager::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 }
 
-void AGridManager::CreateBaseMaterial()
-{
-#if WITH_EDITORONLY_DATA
-	UMaterial* Mat = NewObject<UMaterial>(GetTransientPackage(), NAME_None, RF_Transient);
-	Mat->MaterialDomain = MD_Surface;
-
-	UMaterialExpressionVectorParameter* ColorParam =
-		NewObject<UMaterialExpressionVectorParameter>(Mat);
-	ColorParam->ParameterName = TEXT("Color");
-	ColorParam->DefaultValue = FLinearColor::White;
-
-	UMaterialEditorOnlyData* EditorData = Mat->GetEditorOnlyData();
-	EditorData->ExpressionCollection.Expressions.Add(ColorParam);
-	EditorData->BaseColor.Expression = ColorParam;
-	EditorData->BaseColor.OutputIndex = 0;
-
-	Mat->PreEditChange(nullptr);
-	Mat->PostEditChange();
-
-	CachedBaseMaterial = Mat;
-	UE_LOG(LogTemp, Log, TEXT("GridManager: Created custom colored material"));
-#else
-	// Fallback: use BasicShapeMaterial (will be white, no color support)
-	CachedBaseMaterial = LoadObject<UMaterialInterface>(nullptr,
-		TEXT("/Engine/BasicShapes/BasicShapeMaterial.BasicShapeMaterial"));
-	UE_LOG(LogTemp, Warning, TEXT("GridManager: Using fallback BasicShapeMaterial (no color support)"));
-#endif
-}
-
 void AGridManager::InitializeGrid()
 {
+	TileGrid.Init(Width, Height);
+	Width = TileGrid.Width;
+	Height = TileGrid.Height;
+
 	GridMap.Empty();
 	for (int32 x = 0; x < Width; ++x)
 	{
@@ -98,8 +340,12 @@ void AGridManager::InitializeGrid()
 		CachedCubeMesh ? TEXT("OK") : TEXT("NULL"),
 		CachedBaseMaterial ? TEXT("OK") : TEXT("NULL"));
 
-	RefreshAllTileVisuals();
-	RefreshAllWallVisuals();
+	// Visuals are built by the first flush, together with any tiles edited this frame
+	if (bBuildVisuals)
+	{
+		ResetVisualInstances();
+		MarkAllTilesDirty();
+	}
 }
 
 FVector AGridManager::GridToWorld(FIntVector Coords) const
@@ -118,16 +364,12 @@ FIntVector AGridManager::WorldToGrid(FVector Location) const
 
 ETileType AGridManager::GetTileType(FIntVector Coords) const
 {
-	if (GridMap.Contains(Coords))
-	{
-		return GridMap[Coords].TileType;
-	}
-	return ETileType::Pit; // Outside grid is considered a pit
+	return TileGrid.GetTileType(Coords.X, Coords.Y);
 }
 
 bool AGridManager::IsInBounds(int32 X, int32 Y) const
 {
-	return X >= 0 && X < Width && Y >= 0 && Y < Height;
+	return TileGrid.IsInBounds(X, Y);
 }
 
 bool AGridManager::IsValidTile(FIntVector Coords) const
@@ -138,9 +380,9 @@ bool AGridManager::IsValidTile(FIntVector Coords) const
 
 FTileData AGridManager::GetTileData(FIntVector Coords) const
 {
-	if (const FTileData* Data = GridMap.Find(Coords))
+	if (const FPackedTile* Tile = TileGrid.Find(Coords.X, Coords.Y))
 	{
-		return *Data;
+		return FTileGrid::Unpack(*Tile);
 	}
 	FTileData PitData;
 	PitData.TileType = ETileType::Pit;
@@ -149,215 +391,366 @@ FTileData AGridManager::GetTileData(FIntVector Coords) const
 
 int32 AGridManager::GetTotalCheckpoints() const
 {
-	int32 Count = 0;
-	for (const auto& Pair : GridMap)
-	{
-		if (Pair.Value.TileType == ETileType::Checkpoint)
-		{
-			Count++;
-		}
-	}
-	return Count;
+	return TileGrid.NumCheckpoints;
+}
+
+bool AGridManager::GetCheckpointPosition(int32 Number, FIntVector& OutCoords) const
+{
+	const int32 Index = TileGrid.FindCheckpoint(Number);
+	if (Index == INDEX_NONE) return false;
+
+	OutCoords = TileGrid.FromIndex(Index);
+	return true;
 }
 
 void AGridManager::SetTileType(FIntVector Coords, const FTileData& Data)
 {
+	FPackedTile* Tile = TileGrid.Find(Coords.X, Coords.Y);
+	if (!Tile)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SetTileType: Coordinates (%d, %d) out of bounds"), Coords.X, Coords.Y);
+		return;
+	}
+
+	TileGrid.SetTile(Coords.X, Coords.Y, FTileGrid::Pack(Data));
 	GridMap.Add(Coords, Data);
 
-	// Update or create the visual mesh for this tile
-	if (UStaticMeshComponent** Existing = TileMeshes.Find(Coords))
-	{
-		// Update material color
-		UMaterialInstanceDynamic* MID = Cast<UMaterialInstanceDynamic>((*Existing)->GetMaterial(0));
-		if (MID)
-		{
-			MID->SetVectorParameterValue(TEXT("Color"), GetTileColor(Data.TileType));
-		}
+	// Visuals update once per frame
+	MarkTileDirty(Coords);
+	OnTileChanged.Broadcast(TileGrid.ToIndex(Coords.X, Coords.Y));
 
-		// Adjust Z for pits
-		FVector Loc = (*Existing)->GetRelativeLocation();
-		Loc.Z = (Data.TileType == ETileType::Pit) ? -5.0f : 0.0f;
-		(*Existing)->SetRelativeLocation(Loc);
-	}
-	else
+	if (HasAuthority())
 	{
-		SpawnTileMesh(Coords, Data);
+		FlushNetDormancy();
 	}
+}
 
-	// Handle conveyor arrow
-	DestroyConveyorArrow(Coords);
-	if (IsConveyor(Data.TileType))
+void AGridManager::ApplyBoard(int32 InWidth, int32 InHeight, TConstArrayView<FPackedTile> InTiles)
+{
+	if (InTiles.Num() != InWidth * InHeight) return;
+
+	if (InWidth != TileGrid.Width || InHeight != TileGrid.Height)
 	{
-		SpawnConveyorArrow(Coords, Data.TileType);
+		Width = InWidth;
+		Height = InHeight;
+		InitializeGrid();
 	}
 
-	// Handle checkpoint label
-	DestroyCheckpointLabel(Coords);
-	if (Data.TileType == ETileType::Checkpoint && Data.CheckpointNumber > 0)
+	for (int32 Index = 0; Index < InTiles.Num(); ++Index)
 	{
-		SpawnCheckpointLabel(Coords, Data.CheckpointNumber);
+		if (TileGrid.Tiles[Index] != InTiles[Index])
+		{
+			SetTileType(TileGrid.FromIndex(Index), FTileGrid::Unpack(InTiles[Index]));
+		}
 	}
 }
 
 void AGridManager::RefreshAllTileVisuals()
 {
-	// Destroy existing tile meshes
-	for (auto& Pair : TileMeshes)
+	if (!bBuildVisuals) return;
+
+	for (int32 y = 0; y < TileGrid.Height; ++y)
 	{
-		if (Pair.Value)
+		for (int32 x = 0; x < TileGrid.Width; ++x)
 		{
-			Pair.Value->DestroyComponent();
+			const FIntVector Coords(x, y, 0);
+			const FPackedTile& Tile = TileGrid.Tiles[TileGrid.ToIndex(x, y)];
+
+			UpdateTileInstance(Coords, Tile.TileType);
+			UpdateArrowInstance(Coords, Tile.TileType);
+			UpdateCheckpointLabel(Coords, Tile);
 		}
 	}
-	TileMeshes.Empty();
+	MarkBatchesRenderStateDirty();
+
+	UE_LOG(LogTemp, Log, TEXT("GridManager: %d tile instances in %d batches"), TileInstances.Num(), TileBatches.Num());
+}
+
+void AGridManager::MarkTileDirty(FIntVector Coords)
+{
+	if (!bBuildVisuals || !TileGrid.IsInBounds(Coords.X, Coords.Y)) return;
+
+	DirtyTiles.Add(TileGrid.ToIndex(Coords.X, Coords.Y));
+
+	if (!bFlushScheduled)
+	{
+		bFlushScheduled = true;
+		GetWorldTimerManager().SetTimerForNextTick(this, &AGridManager::FlushDirtyTiles);
+	}
+}
 
-	// Destroy existing arrow meshes
-	for (auto& Pair : ArrowMeshes)
+void AGridManager::MarkAllTilesDirty()
+{
+	for (int32 y = 0; y < TileGrid.Height; ++y)
 	{
-		if (Pair.Value)
+		for (int32 x = 0; x < TileGrid.Width; ++x)
 		{
-			Pair.Value->DestroyComponent();
+			MarkTileDirty(FIntVector(x, y, 0));
 		}
 	}
-	ArrowMeshes.Empty();
+}
 
-	// Destroy existing checkpoint labels
-	for (auto& Pair : CheckpointLabels)
+void AGridManager::FlushDirtyTiles()
+{
+	bFlushScheduled = false;
+	if (DirtyTiles.Num() == 0) return;
+
+	for (int32 TileIndex : DirtyTiles)
 	{
-		if (Pair.Value)
+		const FIntVector Coords(TileIndex % TileGrid.Width, TileIndex / TileGrid.Width, 0);
+		const FPackedTile& Tile = TileGrid.Tiles[TileIndex];
+
+		UpdateTileInstance(Coords, Tile.TileType);
+		UpdateArrowInstance(Coords, Tile.TileType);
+		UpdateCheckpointLabel(Coords, Tile);
+		RefreshWallVisual(Coords);
+	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("GridManager: Flushed %d dirty tiles"), DirtyTiles.Num());
+
+	DirtyTiles.Reset();
+	MarkBatchesRenderStateDirty();
+}
+
+void AGridManager::MarkBatchesRenderStateDirty()
+{
+	// Instance edits skip the per-call render state update; push them once here
+	for (auto& Pair : TileBatches)
+	{
+		if (Pair.Value.Component)
 		{
-			Pair.Value->DestroyComponent();
+			Pair.Value.Component->MarkRenderStateDirty();
 		}
 	}
-	CheckpointLabels.Empty();
+	if (ArrowBatch.Component) ArrowBatch.Component->MarkRenderStateDirty();
+	if (WallBatch.Component) WallBatch.Component->MarkRenderStateDirty();
+}
 
-	// Spawn new meshes for all tiles
-	for (auto& Pair : GridMap)
+void AGridManager::ResetVisualInstances()
+{
+	for (auto& Pair : TileBatches)
 	{
-		SpawnTileMesh(Pair.Key, Pair.Value);
-		if (IsConveyor(Pair.Value.TileType))
+		if (Pair.Value.Component)
 		{
-			SpawnConveyorArrow(Pair.Key, Pair.Value.TileType);
+			Pair.Value.Component->ClearInstances();
 		}
-		if (Pair.Value.TileType == ETileType::Checkpoint && Pair.Value.CheckpointNumber > 0)
+		Pair.Value.FreeInstances.Reset();
+	}
+	for (FGridInstanceBatch* Batch : { &ArrowBatch, &WallBatch })
+	{
+		if (Batch->Component)
 		{
-			SpawnCheckpointLabel(Pair.Key, Pair.Value.CheckpointNumber);
+			Batch->Component->ClearInstances();
 		}
+		Batch->FreeInstances.Reset();
+	}
+
+	// Park labels in the pool
+	for (auto& Pair : CheckpointLabels)
+	{
+		ReleaseCheckpointLabel(Pair.Value);
 	}
+	CheckpointLabels.Empty();
+	DirtyTiles.Reset();
 
-	UE_LOG(LogTemp, Log, TEXT("GridManager: Spawned %d tile meshes"), TileMeshes.Num());
+	const int32 NumTiles = TileGrid.Tiles.Num();
+	TileInstances.Init(FTileInstance(), NumTiles);
+	ArrowInstances.Init(INDEX_NONE, NumTiles);
+	WallInstances.Init(INDEX_NONE, NumTiles * 4);
 }
 
-void AGridManager::SpawnTileMesh(FIntVector Coords, const FTileData& Data)
+void AGridManager::InitBatch(FGridInstanceBatch& Batch, UStaticMesh* Mesh, const TCHAR* BaseName)
 {
-	// Determine which mesh to use: per-type > general custom > engine fallback
-	UStaticMesh* MeshToUse = nullptr;
+	UInstancedStaticMeshComponent* ISM = NewObject<UInstancedStaticMeshComponent>(
+		this, MakeUniqueObjectName(this, UInstancedStaticMeshComponent::StaticClass(), FName(BaseName)));
+	ISM->SetupAttachment(RootComponent);
+	ISM->SetStaticMesh(Mesh);
 
-	if (UStaticMesh** TypeMesh = TileTypeMeshes.Find(Data.TileType))
+	// Per-instance RGB color read by the shared base material
+	ISM->NumCustomDataFloats = 3;
+	if (CachedBaseMaterial)
 	{
-		MeshToUse = *TypeMesh;
+		ISM->SetMaterial(0, CachedBaseMaterial);
 	}
-	else if (TileMeshAsset)
+
+	ISM->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	ISM->RegisterComponent();
+
+	Batch.Component = ISM;
+	Batch.FreeInstances.Reset();
+}
+
+int32 AGridManager::AddBatchInstance(FGridInstanceBatch& Batch, const FTransform& Transform, const FLinearColor& Color)
+{
+	if (!Batch.Component) return INDEX_NONE;
+
+	// Reuse a hidden slot before growing the instance buffer
+	int32 Instance;
+	if (Batch.FreeInstances.Num() > 0)
 	{
-		MeshToUse = TileMeshAsset;
+		Instance = Batch.FreeInstances.Pop(EAllowShrinking::No);
+		Batch.Component->UpdateInstanceTransform(Instance, Transform, false, false);
 	}
 	else
 	{
-		MeshToUse = CachedCubeMesh;
+		Instance = Batch.Component->AddInstance(Transform);
+	}
+
+	SetBatchInstanceColor(Batch, Instance, Color);
+	return Instance;
+}
+
+void AGridManager::RemoveBatchInstance(FGridInstanceBatch& Batch, int32 Instance)
+{
+	if (!Batch.Component || Instance == INDEX_NONE) return;
+
+	// Hide with a zero scale instead of removing, so other instance indices stay stable
+	static const FTransform HiddenTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+	Batch.Component->UpdateInstanceTransform(Instance, HiddenTransform, false, false);
+	Batch.FreeInstances.Add(Instance);
+}
+
+void AGridManager::SetBatchInstanceColor(FGridInstanceBatch& Batch, int32 Instance, const FLinearColor& Color)
+{
+	const float CustomData[3] = { Color.R, Color.G, Color.B };
+	Batch.Component->SetCustomData(Instance, CustomData, false);
+}
+
+UStaticMesh* AGridManager::GetTileMesh(ETileType Type) const
+{
+	// Per-type > general custom > engine fallback
+	if (UStaticMesh* const* TypeMesh = TileTypeMeshes.Find(Type))
+	{
+		if (*TypeMesh) return *TypeMesh;
 	}
+	return TileMeshAsset ? TileMeshAsset : CachedCubeMesh;
+}
 
+void AGridManager::UpdateTileInstance(FIntVector Coords, ETileType Type)
+{
+	if (!TileInstances.IsValidIndex(TileGrid.ToIndex(Coords.X, Coords.Y))) return;
+	FTileInstance& Slot = TileInstances[TileGrid.ToIndex(Coords.X, Coords.Y)];
+
+	UStaticMesh* MeshToUse = GetTileMesh(Type);
 	if (!MeshToUse)
 	{
 		UE_LOG(LogTemp, Error, TEXT("GridManager: No mesh available for tile, cannot spawn"));
 		return;
 	}
 
-	FString CompName = FString::Printf(TEXT("Tile_%d_%d"), Coords.X, Coords.Y);
-	UStaticMeshComponent* TileMesh = NewObject<UStaticMeshComponent>(this, FName(*CompName));
-	TileMesh->SetupAttachment(RootComponent);
-	TileMesh->SetStaticMesh(MeshToUse);
-
-	// Position relative to grid origin
+	// Position relative to grid origin, pits sunk slightly
 	FVector TilePos(Coords.X * TileSize, Coords.Y * TileSize, 0.0f);
-	if (Data.TileType == ETileType::Pit)
+	if (Type == ETileType::Pit)
 	{
 		TilePos.Z = -5.0f;
 	}
-	TileMesh->SetRelativeLocation(TilePos);
 
 	// Scale: Cube default is 100x100x100, scale to tile size with small gap
-	float TileScale = TileSize / 100.0f * 0.96f;
-	TileMesh->SetRelativeScale3D(FVector(TileScale, TileScale, 0.05f));
+	const float TileScale = TileSize / 100.0f * 0.96f;
+	const FTransform Transform(FRotator::ZeroRotator, TilePos, FVector(TileScale, TileScale, 0.05f));
 
-	// Create colored material
-	if (CachedBaseMaterial)
+	// Same mesh: update in place
+	if (Slot.Mesh == MeshToUse && Slot.Instance != INDEX_NONE)
 	{
-		UMaterialInstanceDynamic* MID = UMaterialInstanceDynamic::Create(CachedBaseMaterial, this);
-		MID->SetVectorParameterValue(TEXT("Color"), GetTileColor(Data.TileType));
-		TileMesh->SetMaterial(0, MID);
+		FGridInstanceBatch& Batch = TileBatches.FindChecked(MeshToUse);
+		Batch.Component->UpdateInstanceTransform(Slot.Instance, Transform, false, false);
+		SetBatchInstanceColor(Batch, Slot.Instance, GetTileColor(Type));
+		return;
 	}
 
-	TileMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	TileMesh->RegisterComponent();
+	// Mesh changed (or first spawn): move the tile to the batch for its mesh
+	if (Slot.Mesh)
+	{
+		if (FGridInstanceBatch* OldBatch = TileBatches.Find(Slot.Mesh))
+		{
+			RemoveBatchInstance(*OldBatch, Slot.Instance);
+		}
+	}
 
-	TileMeshes.Add(Coords, TileMesh);
+	FGridInstanceBatch& Batch = TileBatches.FindOrAdd(MeshToUse);
+	if (!Batch.Component)
+	{
+		InitBatch(Batch, MeshToUse, TEXT("TileInstances"));
+	}
+
+	Slot.Mesh = MeshToUse;
+	Slot.Instance = AddBatchInstance(Batch, Transform, GetTileColor(Type));
 }
 
-void AGridManager::SpawnConveyorArrow(FIntVector Coords, ETileType Type)
+void AGridManager::UpdateArrowInstance(FIntVector Coords, ETileType Type)
 {
-	if (!CachedConeMesh || !CachedBaseMaterial) return;
+	if (!ArrowInstances.IsValidIndex(TileGrid.ToIndex(Coords.X, Coords.Y))) return;
+	int32& Instance = ArrowInstances[TileGrid.ToIndex(Coords.X, Coords.Y)];
 
-	FString CompName = FString::Printf(TEXT("Arrow_%d_%d"), Coords.X, Coords.Y);
-	UStaticMeshComponent* Arrow = NewObject<UStaticMeshComponent>(this, FName(*CompName));
-	Arrow->SetupAttachment(RootComponent);
-	Arrow->SetStaticMesh(CachedConeMesh);
+	if (!IsConveyor(Type))
+	{
+		RemoveBatchInstance(ArrowBatch, Instance);
+		Instance = INDEX_NONE;
+		return;
+	}
 
-	// Position on top of tile
-	FVector ArrowPos(Coords.X * TileSize, Coords.Y * TileSize, 4.0f);
-	Arrow->SetRelativeLocation(ArrowPos);
+	if (!CachedConeMesh || !CachedBaseMaterial) return;
 
-	// Tilt cone to lay flat (pitch -90), then yaw for direction
-	float Yaw = GetConveyorYaw(Type);
-	Arrow->SetRelativeRotation(FRotator(-90.0f, Yaw, 0.0f));
+	if (!ArrowBatch.Component)
+	{
+		InitBatch(ArrowBatch, CachedConeMesh, TEXT("ArrowInstances"));
+	}
 
-	// Scale small
-	Arrow->SetRelativeScale3D(FVector(0.18f, 0.18f, 0.25f));
+	// On top of the tile; tilt cone to lay flat (pitch -90), then yaw for direction, scale small
+	const FTransform Transform(
+		FRotator(-90.0f, GetConveyorYaw(Type), 0.0f),
+		FVector(Coords.X * TileSize, Coords.Y * TileSize, 4.0f),
+		FVector(0.18f, 0.18f, 0.25f));
 
-	// Bright arrow color
-	UMaterialInstanceDynamic* MID = UMaterialInstanceDynamic::Create(CachedBaseMaterial, this);
-	MID->SetVectorParameterValue(TEXT("Color"), FLinearColor(0.9f, 0.95f, 1.0f));
-	Arrow->SetMaterial(0, MID);
-
-	Arrow->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	Arrow->RegisterComponent();
+	if (Instance != INDEX_NONE)
+	{
+		ArrowBatch.Component->UpdateInstanceTransform(Instance, Transform, false, false);
+		return;
+	}
 
-	ArrowMeshes.Add(Coords, Arrow);
+	// Bright arrow color
+	Instance = AddBatchInstance(ArrowBatch, Transform, FLinearColor(0.9f, 0.95f, 1.0f));
 }
 
-void AGridManager::DestroyConveyorArrow(FIntVector Coords)
+void AGridManager::UpdateCheckpointLabel(FIntVector Coords, const FPackedTile& Tile)
 {
-	if (UStaticMeshComponent** Existing = ArrowMeshes.Find(Coords))
+	const bool bWantsLabel = Tile.TileType == ETileType::Checkpoint && Tile.CheckpointNumber > 0;
+	UTextRenderComponent* Label = CheckpointLabels.FindRef(Coords);
+
+	if (!bWantsLabel)
 	{
-		if (*Existing)
+		if (Label)
 		{
-			(*Existing)->DestroyComponent();
+			ReleaseCheckpointLabel(Label);
+			CheckpointLabels.Remove(Coords);
 		}
-		ArrowMeshes.Remove(Coords);
+		return;
 	}
-}
 
-void AGridManager::SpawnCheckpointLabel(FIntVector Coords, int32 CheckpointNumber)
-{
-	FString CompName = FString::Printf(TEXT("Checkpoint_%d_%d"), Coords.X, Coords.Y);
-	UTextRenderComponent* Label = NewObject<UTextRenderComponent>(this, FName(*CompName));
-	Label->SetupAttachment(RootComponent);
+	if (!Label)
+	{
+		Label = AcquireCheckpointLabel();
+		CheckpointLabels.Add(Coords, Label);
+
+		// Position above the tile
+		Label->SetRelativeLocation(FVector(Coords.X * TileSize, Coords.Y * TileSize, 10.0f));
+		Label->SetVisibility(true);
+	}
 
 	// Set the text to the checkpoint number
-	Label->SetText(FText::AsNumber(CheckpointNumber));
+	Label->SetText(FText::AsNumber(Tile.CheckpointNumber));
+}
 
-	// Position above the tile
-	FVector LabelPos(Coords.X * TileSize, Coords.Y * TileSize, 10.0f);
-	Label->SetRelativeLocation(LabelPos);
+UTextRenderComponent* AGridManager::AcquireCheckpointLabel()
+{
+	if (LabelPool.Num() > 0)
+	{
+		return LabelPool.Pop(EAllowShrinking::No);
+	}
+
+	UTextRenderComponent* Label = NewObject<UTextRenderComponent>(
+		this, MakeUniqueObjectName(this, UTextRenderComponent::StaticClass(), TEXT("CheckpointLabel")));
+	Label->SetupAttachment(RootComponent);
 
 	// Rotate to face upward - Pitch 90 to lay flat, Roll 180 to flip right way up
 	Label->SetRelativeRotation(FRotator(90.0f, 0.0f, 180.0f));
@@ -369,20 +762,15 @@ void AGridManager::SpawnCheckpointLabel(FIntVector Coords, int32 CheckpointNumbe
 	Label->SetVerticalAlignment(EVerticalTextAligment::EVRTA_TextCenter);
 
 	Label->RegisterComponent();
-
-	CheckpointLabels.Add(Coords, Label);
+	return Label;
 }
 
-void AGridManager::DestroyCheckpointLabel(FIntVector Coords)
+void AGridManager::ReleaseCheckpointLabel(UTextRenderComponent* Label)
 {
-	if (UTextRenderComponent** Existing = CheckpointLabels.Find(Coords))
-	{
-		if (*Existing)
-		{
-			(*Existing)->DestroyComponent();
-		}
-		CheckpointLabels.Remove(Coords);
-	}
+	if (!Label) return;
+
+	Label->SetVisibility(false);
+	LabelPool.Add(Label);
 }
 
 bool AGridManager::IsConveyor(ETileType Type)
@@ -449,11 +837,7 @@ EGridDirection AGridManager::GetOppositeDirection(EGridDirection Direction) cons
 
 bool AGridManager::HasWall(FIntVector Coords, EGridDirection Direction) const
 {
-	const FTileData* Data = GridMap.Find(Coords);
-	if (!Data) return false;
-
-	uint8 WallFlag = DirectionToWallFlag(Direction);
-	return (Data->Walls & WallFlag) != 0;
+	return TileGrid.HasWall(Coords.X, Coords.Y, DirectionToWallFlag(Direction));
 }
 
 void AGridManager::SetWall(FIntVector Coords, EGridDirection Direction, bool bEnabled)
@@ -464,56 +848,37 @@ void AGridManager::SetWall(FIntVector Coords, EGridDirection Direction, bool bEn
 		return;
 	}
 
-	FTileData& Data = GridMap.FindOrAdd(Coords);
+	FPackedTile* Tile = TileGrid.Find(Coords.X, Coords.Y);
+	if (!Tile) return;
+
 	uint8 WallFlag = DirectionToWallFlag(Direction);
 
 	if (bEnabled)
 	{
-		Data.Walls |= WallFlag;  // Set bit
+		Tile->Walls |= WallFlag;  // Set bit
 	}
 	else
 	{
-		Data.Walls &= ~WallFlag;  // Clear bit
+		Tile->Walls &= ~WallFlag;  // Clear bit
 	}
 
-	// Update visual
-	RefreshWallVisual(Coords);
-}
+	// Mirror into the editor view
+	GridMap.FindOrAdd(Coords).Walls = Tile->Walls;
+	TileGrid.UpdateConveyorLinksAround(Coords.X, Coords.Y);
 
-bool AGridManager::IsMovementBlocked(FIntVector FromCoords, FIntVector ToCoords) const
-{
-	// Calculate movement direction
-	int32 DX = ToCoords.X - FromCoords.X;
-	int32 DY = ToCoords.Y - FromCoords.Y;
-
-	// Not adjacent tiles - no wall blocking (diagonal/invalid movement)
-	if (FMath::Abs(DX) + FMath::Abs(DY) != 1)
-	{
-		return false;
-	}
+	// Visuals update once per frame
+	MarkTileDirty(Coords);
+	OnTileChanged.Broadcast(TileGrid.ToIndex(Coords.X, Coords.Y));
 
-	// Determine direction
-	EGridDirection Direction;
-	if (DX == 1 && DY == 0)       Direction = EGridDirection::North;
-	else if (DX == -1 && DY == 0) Direction = EGridDirection::South;
-	else if (DX == 0 && DY == 1)  Direction = EGridDirection::East;
-	else if (DX == 0 && DY == -1) Direction = EGridDirection::West;
-	else return false;
-
-	// Check wall on the from-tile side
-	if (HasWall(FromCoords, Direction))
+	if (HasAuthority())
 	{
-		return true;
-	}
-
-	// Check wall on the to-tile side (opposite direction)
-	EGridDirection OppositeDir = GetOppositeDirection(Direction);
-	if (HasWall(ToCoords, OppositeDir))
-	{
-		return true;
+		FlushNetDormancy();
 	}
+}
 
-	return false;
+bool AGridManager::IsMovementBlocked(FIntVector FromCoords, FIntVector ToCoords) const
+{
+	return TileGrid.IsMovementBlocked(FromCoords.X, FromCoords.Y, ToCoords.X, ToCoords.Y);
 }
 
 FVector AGridManager::GetWallOffset(EGridDirection Direction) const
@@ -554,112 +919,71 @@ FVector AGridManager::GetWallScale() const
 	return FVector(ThicknessScale, LengthScale, HeightScale);
 }
 
-void AGridManager::SpawnWallMesh(FIntVector Coords, EGridDirection Direction)
-{
-	UStaticMesh* MeshToUse = WallMeshAsset ? WallMeshAsset : CachedCubeMesh;
-	if (!MeshToUse)
-	{
-		UE_LOG(LogTemp, Error, TEXT("SpawnWallMesh: No mesh available"));
-		return;
-	}
-
-	// Create unique key for this wall (Coords + Direction)
-	int32 WallKey = Coords.X + Coords.Y * 1000 + static_cast<int32>(Direction) * 1000000;
-
-	// Check if wall already exists
-	if (WallMeshes.Contains(WallKey))
-	{
-		return;  // Already exists
-	}
-
-	// Create wall mesh component
-	FString CompName = FString::Printf(TEXT("Wall_%d_%d_%d"), Coords.X, Coords.Y, static_cast<int32>(Direction));
-	UStaticMeshComponent* WallMesh = NewObject<UStaticMeshComponent>(this, FName(*CompName));
-	WallMesh->SetupAttachment(RootComponent);
-	WallMesh->SetStaticMesh(MeshToUse);
-
-	// Position at tile edge
-	FVector TilePos(Coords.X * TileSize, Coords.Y * TileSize, 0.0f);
-	FVector WallPos = TilePos + GetWallOffset(Direction);
-	WallMesh->SetRelativeLocation(WallPos);
-
-	// Rotate for direction
-	WallMesh->SetRelativeRotation(GetWallRotation(Direction));
-
-	// Scale to wall dimensions
-	WallMesh->SetRelativeScale3D(GetWallScale());
-
-	// Dark gray material
-	if (CachedBaseMaterial)
-	{
-		UMaterialInstanceDynamic* MID = UMaterialInstanceDynamic::Create(CachedBaseMaterial, this);
-		MID->SetVectorParameterValue(TEXT("Color"), FLinearColor(0.15f, 0.15f, 0.15f));
-		WallMesh->SetMaterial(0, MID);
-	}
-
-	WallMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	WallMesh->RegisterComponent();
-
-	WallMeshes.Add(WallKey, WallMesh);
-}
-
 void AGridManager::RefreshWallVisual(FIntVector Coords)
 {
-	if (!IsInBounds(Coords.X, Coords.Y)) return;
-
-	const FTileData* Data = GridMap.Find(Coords);
+	const FPackedTile* Data = TileGrid.Find(Coords.X, Coords.Y);
 	if (!Data) return;
 
-	// Check each direction and spawn/destroy walls as needed
+	const int32 TileIndex = TileGrid.ToIndex(Coords.X, Coords.Y);
+	if (!WallInstances.IsValidIndex(TileIndex * 4 + 3)) return;
+
+	// Check each direction and add/hide wall instances as needed
 	for (int32 i = 0; i < 4; ++i)
 	{
 		EGridDirection Dir = static_cast<EGridDirection>(i);
-		int32 WallKey = Coords.X + Coords.Y * 1000 + i * 1000000;
+		int32& Instance = WallInstances[TileIndex * 4 + i];
 
 		bool bShouldHaveWall = (Data->Walls & DirectionToWallFlag(Dir)) != 0;
-		bool bHasWallMesh = WallMeshes.Contains(WallKey);
+		bool bHasWallInstance = Instance != INDEX_NONE;
 
-		if (bShouldHaveWall && !bHasWallMesh)
+		if (bShouldHaveWall && !bHasWallInstance)
 		{
-			// Spawn wall
-			SpawnWallMesh(Coords, Dir);
+			Instance = AddWallInstance(Coords, Dir);
 		}
-		else if (!bShouldHaveWall && bHasWallMesh)
+		else if (!bShouldHaveWall && bHasWallInstance)
 		{
-			// Destroy wall
-			if (UStaticMeshComponent* WallMesh = WallMeshes[WallKey])
-			{
-				WallMesh->DestroyComponent();
-			}
-			WallMeshes.Remove(WallKey);
+			RemoveBatchInstance(WallBatch, Instance);
+			Instance = INDEX_NONE;
 		}
 	}
 }
 
-void AGridManager::RefreshAllWallVisuals()
+int32 AGridManager::AddWallInstance(FIntVector Coords, EGridDirection Direction)
 {
-	// Destroy all existing walls
-	for (auto& Pair : WallMeshes)
+	UStaticMesh* MeshToUse = WallMeshAsset ? WallMeshAsset : CachedCubeMesh;
+	if (!MeshToUse)
 	{
-		if (Pair.Value)
-		{
-			Pair.Value->DestroyComponent();
-		}
+		UE_LOG(LogTemp, Error, TEXT("AddWallInstance: No mesh available"));
+		return INDEX_NONE;
 	}
-	WallMeshes.Empty();
 
-	// Spawn walls for all tiles
-	for (auto& TilePair : GridMap)
+	if (!WallBatch.Component)
 	{
-		const FIntVector& Coords = TilePair.Key;
-		const FTileData& Data = TilePair.Value;
+		InitBatch(WallBatch, MeshToUse, TEXT("WallInstances"));
+	}
 
-		// Check each direction
-		if (Data.Walls & WALL_NORTH) SpawnWallMesh(Coords, EGridDirection::North);
-		if (Data.Walls & WALL_EAST)  SpawnWallMesh(Coords, EGridDirection::East);
-		if (Data.Walls & WALL_SOUTH) SpawnWallMesh(Coords, EGridDirection::South);
-		if (Data.Walls & WALL_WEST)  SpawnWallMesh(Coords, EGridDirection::West);
+	// Position at tile edge, rotated for direction, scaled to wall dimensions
+	FVector TilePos(Coords.X * TileSize, Coords.Y * TileSize, 0.0f);
+	const FTransform Transform(GetWallRotation(Direction), TilePos + GetWallOffset(Direction), GetWallScale());
+
+	// Dark gray
+	return AddBatchInstance(WallBatch, Transform, FLinearColor(0.15f, 0.15f, 0.15f));
+}
+
+void AGridManager::RefreshAllWallVisuals()
+{
+	if (!bBuildVisuals) return;
+
+	int32 WallCount = 0;
+	for (int32 y = 0; y < TileGrid.Height; ++y)
+	{
+		for (int32 x = 0; x < TileGrid.Width; ++x)
+		{
+			RefreshWallVisual(FIntVector(x, y, 0));
+			WallCount += FMath::CountBits(TileGrid.Tiles[TileGrid.ToIndex(x, y)].Walls);
+		}
 	}
+	MarkBatchesRenderStateDirty();
 
-	UE_LOG(LogTemp, Log, TEXT("GridManager: Spawned %d wall meshes"), WallMeshes.Num());
+	UE_LOG(LogTemp, Log, TEXT("GridManager: %d wall instances"), WallCount);
 }
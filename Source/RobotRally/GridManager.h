@@ -6,6 +6,7 @@
 #include "GameFramework/Actor.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/TextRenderComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "GridManager.generated.h"
 
 // Forward declare EGridDirection (defined in RobotMovementComponent.h)
@@ -46,6 +47,145 @@ struct FTileData
 	uint8 Walls = 0;
 };
 
+// Packed per-tile rules data (4 bytes per tile)
+struct FPackedTile
+{
+	ETileType TileType = ETileType::Normal;
+	uint8 CheckpointNumber = 0;
+	uint8 Walls = 0;
+	uint8 Padding = 0;
+
+	bool operator==(const FPackedTile& Other) const
+	{
+		return TileType == Other.TileType && CheckpointNumber == Other.CheckpointNumber && Walls == Other.Walls;
+	}
+	bool operator!=(const FPackedTile& Other) const { return !(*this == Other); }
+};
+
+// Precomputed conveyor move for one tile
+struct FConveyorLink
+{
+	int32 NextIndex = INDEX_NONE;  // Destination tile; INDEX_NONE if not a conveyor, blocked, or exit is off-board
+	bool bWallBlocked = false;     // Exit blocked by a wall
+	int8 Rotation = 0;             // Turn applied on arrival at a bending belt (+1 right, -1 left)
+};
+
+/**
+ * Dense row-major tile store indexed by X + Y * Width.
+ * Authoritative source for all rules queries; AGridManager::GridMap only mirrors it
+ * for the editor and serialization.
+ */
+struct ROBOTRALLY_API FTileGrid
+{
+	// Tile indices are replicated and stored in the board blob as 16 bits
+	static constexpr int32 MaxTiles = MAX_uint16 + 1;
+
+	int32 Width = 0;
+	int32 Height = 0;
+	TArray<FPackedTile> Tiles;
+
+	// Conveyor successor table, parallel to Tiles
+	TArray<FConveyorLink> ConveyorLinks;
+
+	// Checkpoint number -> tile index (INDEX_NONE if that number is not on the board)
+	TArray<int32> CheckpointTiles;
+
+	// Number of Checkpoint tiles on the board
+	int32 NumCheckpoints = 0;
+
+	// Resize to InWidth x InHeight and reset every tile to Normal without walls.
+	// Boards over MaxTiles tiles are cut down to fit.
+	void Init(int32 InWidth, int32 InHeight);
+
+	FORCEINLINE bool IsInBounds(int32 X, int32 Y) const
+	{
+		// Unsigned compare folds the negative checks into the upper bound check
+		return static_cast<uint32>(X) < static_cast<uint32>(Width)
+			&& static_cast<uint32>(Y) < static_cast<uint32>(Height);
+	}
+
+	FORCEINLINE int32 ToIndex(int32 X, int32 Y) const { return X + Y * Width; }
+	FORCEINLINE FIntVector FromIndex(int32 Index) const { return FIntVector(Index % Width, Index / Width, 0); }
+
+	// Returns nullptr when (X, Y) is outside the grid
+	FORCEINLINE const FPackedTile* Find(int32 X, int32 Y) const
+	{
+		return IsInBounds(X, Y) ? Tiles.GetData() + ToIndex(X, Y) : nullptr;
+	}
+
+	FORCEINLINE FPackedTile* Find(int32 X, int32 Y)
+	{
+		return IsInBounds(X, Y) ? Tiles.GetData() + ToIndex(X, Y) : nullptr;
+	}
+
+	// Outside grid is considered a pit
+	FORCEINLINE ETileType GetTileType(int32 X, int32 Y) const
+	{
+		const FPackedTile* Tile = Find(X, Y);
+		return Tile ? Tile->TileType : ETileType::Pit;
+	}
+
+	FORCEINLINE bool HasWall(int32 X, int32 Y, uint8 WallFlag) const
+	{
+		const FPackedTile* Tile = Find(X, Y);
+		return Tile && (Tile->Walls & WallFlag) != 0;
+	}
+
+	// Tile index of checkpoint Number, or INDEX_NONE
+	FORCEINLINE int32 FindCheckpoint(int32 Number) const
+	{
+		return CheckpointTiles.IsValidIndex(Number) ? CheckpointTiles[Number] : INDEX_NONE;
+	}
+
+	// Replace a tile, keeping the checkpoint table and conveyor links up to date
+	void SetTile(int32 X, int32 Y, const FPackedTile& NewTile);
+
+	// True if a wall on either side of the shared edge blocks a single orthogonal step
+	bool IsMovementBlocked(int32 FromX, int32 FromY, int32 ToX, int32 ToY) const;
+
+	// Wall flag for a direction (EGridDirection order matches the WALL_* bit order)
+	static FORCEINLINE uint8 WallFlag(EGridDirection Direction) { return 1 << static_cast<uint8>(Direction); }
+
+	// Recompute conveyor links after a tile or wall change at (X, Y); neighbours feeding into it are refreshed too
+	void UpdateConveyorLinksAround(int32 X, int32 Y);
+	void RebuildConveyorLinks();
+
+	// Belt direction as an EGridDirection value, or -1 if the tile is not a conveyor
+	static int32 GetConveyorDirection(ETileType Type);
+
+	static FPackedTile Pack(const FTileData& Data);
+	static FTileData Unpack(const FPackedTile& Tile);
+
+	// Board contents as a compact blob: 16-bit width and height, then type/walls/checkpoint per tile
+	void WriteBoardBlob(TArray<uint8>& OutBlob) const;
+	static bool ReadBoardBlob(TConstArrayView<uint8> Blob, int32& OutWidth, int32& OutHeight, TArray<FPackedTile>& OutTiles);
+
+	// Init from a board blob (no actor needed); false and unchanged if the blob is malformed
+	bool InitFromBoardBlob(TConstArrayView<uint8> Blob);
+
+	// Content hash identifying a board blob
+	static uint64 HashBoardBlob(TConstArrayView<uint8> Blob);
+
+private:
+	void UpdateConveyorLink(int32 X, int32 Y);
+};
+
+// Tile data or walls changed at a TileGrid index
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGridTileChanged, int32 /*TileIndex*/);
+
+// One instanced mesh component for every board piece sharing a mesh.
+// Removed instances are hidden (zero scale) and recycled so indices stay stable.
+USTRUCT()
+struct FGridInstanceBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Component = nullptr;
+
+	TArray<int32> FreeInstances;
+};
+
 UCLASS()
 class ROBOTRALLY_API AGridManager : public AActor
 {
@@ -78,9 +218,13 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Grid|Meshes")
 	TMap<ETileType, UStaticMesh*> TileTypeMeshes;
 
+	// Editor/serialization view of the board; rules queries read TileGrid instead
 	UPROPERTY(VisibleAnywhere, Category = "Grid")
 	TMap<FIntVector, FTileData> GridMap;
 
+	// Read-only access to the dense tile store
+	const FTileGrid& GetTileGrid() const { return TileGrid; }
+
 	// Convert grid coordinates to world location
 	UFUNCTION(BlueprintPure, Category = "Grid")
 	FVector GridToWorld(FIntVector Coords) const;
@@ -109,13 +253,26 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Grid")
 	int32 GetTotalCheckpoints() const;
 
+	// Find the tile holding checkpoint Number; returns false if there is none
+	UFUNCTION(BlueprintPure, Category = "Grid")
+	bool GetCheckpointPosition(int32 Number, FIntVector& OutCoords) const;
+
 	// Set tile type and update visual
 	UFUNCTION(BlueprintCallable, Category = "Grid")
 	void SetTileType(FIntVector Coords, const FTileData& Data);
 
-	// Refresh all tile visuals from current GridMap state
+	// Replace the whole board (resizing if needed); only tiles that differ are touched
+	void ApplyBoard(int32 InWidth, int32 InHeight, TConstArrayView<FPackedTile> InTiles);
+
+	// Refresh all tile visuals from current tile state
 	void RefreshAllTileVisuals();
 
+	// Broadcast after SetTileType/SetWall (used by the GameState to replicate board edits)
+	FOnGridTileChanged OnTileChanged;
+
+	// False on a dedicated server, where the board keeps rules data only
+	bool HasVisuals() const { return bBuildVisuals; }
+
 	// Get color for a tile type
 	static FLinearColor GetTileColor(ETileType Type);
 
@@ -138,20 +295,35 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Grid|Walls")
 	bool IsMovementBlocked(FIntVector FromCoords, FIntVector ToCoords) const;
 
-	// Refresh all wall visuals from current GridMap state
+	// Refresh all wall visuals from current tile state
 	void RefreshAllWallVisuals();
 
 private:
 	void InitializeGrid();
-	void SpawnTileMesh(FIntVector Coords, const FTileData& Data);
-	void SpawnConveyorArrow(FIntVector Coords, ETileType Type);
-	void DestroyConveyorArrow(FIntVector Coords);
-	void SpawnCheckpointLabel(FIntVector Coords, int32 CheckpointNumber);
-	void DestroyCheckpointLabel(FIntVector Coords);
-	void CreateBaseMaterial();
+
+	// Dirty-tile batching: edits are collected and applied once per frame
+	void MarkTileDirty(FIntVector Coords);
+	void MarkAllTilesDirty();
+	void FlushDirtyTiles();
+	void MarkBatchesRenderStateDirty();
+
+	// Checkpoint labels (pooled text components)
+	void UpdateCheckpointLabel(FIntVector Coords, const FPackedTile& Tile);
+	UTextRenderComponent* AcquireCheckpointLabel();
+	void ReleaseCheckpointLabel(UTextRenderComponent* Label);
+
+	// Instanced visual helpers
+	void ResetVisualInstances();
+	void InitBatch(FGridInstanceBatch& Batch, UStaticMesh* Mesh, const TCHAR* BaseName);
+	int32 AddBatchInstance(FGridInstanceBatch& Batch, const FTransform& Transform, const FLinearColor& Color);
+	void RemoveBatchInstance(FGridInstanceBatch& Batch, int32 Instance);
+	void SetBatchInstanceColor(FGridInstanceBatch& Batch, int32 Instance, const FLinearColor& Color);
+	UStaticMesh* GetTileMesh(ETileType Type) const;
+	void UpdateTileInstance(FIntVector Coords, ETileType Type);
+	void UpdateArrowInstance(FIntVector Coords, ETileType Type);
 
 	// Wall visual helpers
-	void SpawnWallMesh(FIntVector Coords, EGridDirection Direction);
+	int32 AddWallInstance(FIntVector Coords, EGridDirection Direction);
 	void RefreshWallVisual(FIntVector Coords);
 	FVector GetWallOffset(EGridDirection Direction) const;
 	FRotator GetWallRotation(EGridDirection Direction) const;
@@ -159,19 +331,43 @@ private:
 	uint8 DirectionToWallFlag(EGridDirection Direction) const;
 	EGridDirection GetOppositeDirection(EGridDirection Direction) const;
 
+	// Dense tile store (rules data), kept in sync with GridMap
+	FTileGrid TileGrid;
+
+	// Tile batches keyed by mesh (per-type meshes get their own batch)
 	UPROPERTY()
-	TMap<FIntVector, UStaticMeshComponent*> TileMeshes;
+	TMap<UStaticMesh*, FGridInstanceBatch> TileBatches;
 
 	UPROPERTY()
-	TMap<FIntVector, UStaticMeshComponent*> ArrowMeshes;
+	FGridInstanceBatch ArrowBatch;
+
+	UPROPERTY()
+	FGridInstanceBatch WallBatch;
+
+	struct FTileInstance
+	{
+		UStaticMesh* Mesh = nullptr;
+		int32 Instance = INDEX_NONE;
+	};
+
+	// Per-tile instance slots, indexed like TileGrid.Tiles (walls: TileIndex * 4 + Direction)
+	TArray<FTileInstance> TileInstances;
+	TArray<int32> ArrowInstances;
+	TArray<int32> WallInstances;
 
 	UPROPERTY()
 	TMap<FIntVector, UTextRenderComponent*> CheckpointLabels;
 
-	// Wall meshes stored by (Coords, Direction) - use a combined key
-	// Key format: X + Y*1000 + DirectionBit*1000000
+	// Hidden labels ready for reuse
 	UPROPERTY()
-	TMap<int32, UStaticMeshComponent*> WallMeshes;
+	TArray<UTextRenderComponent*> LabelPool;
+
+	// Tile indices (TileGrid.ToIndex) whose visuals need updating
+	TSet<int32> DirtyTiles;
+	bool bFlushScheduled = false;
+
+	// Materials, instances and labels are only built where something renders
+	bool bBuildVisuals = true;
 
 	UPROPERTY()
 	USceneComponent* SceneRoot;
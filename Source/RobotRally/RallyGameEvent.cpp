@@ -0,0 +1,98 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#include "RallyGameEvent.h"
+#include "RobotRallyGameMode.h"
+
+FString FRallyGameEvent::ToText(FColor& OutColor) const
+{
+	switch (Type)
+	{
+	case ERallyGameEventType::CardPlayed:
+		OutColor = FColor::White;
+		return FString::Printf(TEXT("R%d: %s (P%d)"),
+			Robot, *ARobotRallyGameMode::GetCardActionName(static_cast<ECardAction>(A)), B);
+
+	case ERallyGameEventType::CardSelected:
+		OutColor = FColor::Green;
+		return FString::Printf(TEXT("Robot %d: R%d = %s (P%d)"),
+			Robot, A + 1, *ARobotRallyGameMode::GetCardActionName(static_cast<ECardAction>(B)), C);
+
+	case ERallyGameEventType::RegisterCleared:
+		OutColor = FColor::Yellow;
+		return FString::Printf(TEXT("Cleared R%d"), A + 1);
+
+	case ERallyGameEventType::PitFall:
+		OutColor = FColor::Red;
+		return FString::Printf(TEXT("R%d fell into pit!"), Robot);
+
+	case ERallyGameEventType::LaserHit:
+		OutColor = FColor::Orange;
+		return FString::Printf(TEXT("R%d hit by laser (-%d HP)"), Robot, A);
+
+	case ERallyGameEventType::ConveyorMove:
+		OutColor = FColor::Cyan;
+		return FString::Printf(TEXT("R%d moved by conveyor"), Robot);
+
+	case ERallyGameEventType::ConveyorBlocked:
+		OutColor = FColor::Yellow;
+		return FString::Printf(A == 0
+			? TEXT("R%d blocked by wall on conveyor")
+			: TEXT("R%d blocked by another robot on conveyor"), Robot);
+
+	case ERallyGameEventType::CheckpointReached:
+		OutColor = FColor::Green;
+		return FString::Printf(TEXT("Checkpoint %d reached! (Respawn point updated)"), A);
+
+	case ERallyGameEventType::CheckpointOutOfOrder:
+		OutColor = FColor::Red;
+		return FString::Printf(TEXT("Wrong order! Need checkpoint %d first."), A);
+
+	case ERallyGameEventType::CheckpointRevisited:
+		OutColor = FColor::Yellow;
+		return FString::Printf(TEXT("Checkpoint %d already visited."), A);
+
+	case ERallyGameEventType::Respawned:
+		OutColor = FColor::Orange;
+		return FString::Printf(TEXT("Robot respawned at (%d, %d). Lives: %d"), A, B, C);
+
+	case ERallyGameEventType::Victory:
+		OutColor = FColor::Green;
+		return FString::Printf(TEXT("VICTORY! Robot %d collected all %d checkpoints!"), Robot, A);
+
+	case ERallyGameEventType::AllDestroyed:
+		OutColor = FColor::Red;
+		return TEXT("GAME OVER - All robots destroyed!");
+	}
+
+	OutColor = FColor::White;
+	return FString();
+}
+
+bool FRallyGameEvent::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint8 TypeByte = static_cast<uint8>(Type);
+	Ar << TypeByte;
+	Ar << Robot;
+	if (Ar.IsLoading() && TypeByte > static_cast<uint8>(ERallyGameEventType::AllDestroyed))
+	{
+		// Unknown event type: malformed or mismatched stream
+		Ar.SetError();
+	}
+	Type = static_cast<ERallyGameEventType>(TypeByte);
+
+	// Params are small and mostly non-negative: zigzag + packed ints, usually one byte each
+	int16* Params[] = { &A, &B, &C };
+	for (int16* Param : Params)
+	{
+		const int32 Value = *Param;
+		uint32 Packed = (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+		Ar.SerializeIntPacked(Packed);
+		if (Ar.IsLoading())
+		{
+			*Param = static_cast<int16>(static_cast<int32>(Packed >> 1) ^ -static_cast<int32>(Packed & 1));
+		}
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RallyGameEvent.generated.h"
+
+// Event log entries sent by the server; text is produced where they are displayed
+UENUM()
+enum class ERallyGameEventType : uint8
+{
+	CardPlayed,            // A = ECardAction, B = priority
+	CardSelected,          // A = register, B = ECardAction, C = priority
+	RegisterCleared,       // A = register
+	PitFall,
+	LaserHit,              // A = damage
+	ConveyorMove,
+	ConveyorBlocked,       // A = 0 wall, 1 another robot
+	CheckpointReached,     // A = checkpoint number
+	CheckpointOutOfOrder,  // A = checkpoint needed next
+	CheckpointRevisited,   // A = checkpoint number
+	Respawned,             // A/B = respawn tile, C = lives remaining
+	Victory,               // A = total checkpoints
+	AllDestroyed
+};
+
+/**
+ * Compact typed event-log record (kind, robot, up to three small params).
+ * Net-serialized as two bytes plus variable-length params.
+ */
+USTRUCT()
+struct ROBOTRALLY_API FRallyGameEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	ERallyGameEventType Type = ERallyGameEventType::CardPlayed;
+
+	UPROPERTY()
+	uint8 Robot = 0;
+
+	UPROPERTY()
+	int16 A = 0;
+
+	UPROPERTY()
+	int16 B = 0;
+
+	UPROPERTY()
+	int16 C = 0;
+
+	// Event log line and its color
+	FString ToText(FColor& OutColor) const;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FRallyGameEvent> : public TStructOpsTypeTraitsBase2<FRallyGameEvent>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
@@ -0,0 +1,82 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#include "RallyMaterialLibrary.h"
+#include "Materials/MaterialInterface.h"
+
+#if WITH_EDITORONLY_DATA
+#include "Materials/Material.h"
+#include "Materials/MaterialExpressionMultiply.h"
+#include "Materials/MaterialExpressionPerInstanceCustomData.h"
+#include "Materials/MaterialExpressionVectorParameter.h"
+#endif
+
+const FName FRallyMaterialLibrary::ColorParameter(TEXT("Color"));
+const TCHAR* FRallyMaterialLibrary::BaseMaterialPath = TEXT("/Game/RobotRally/Materials/M_RallyBase.M_RallyBase");
+
+namespace
+{
+#if WITH_EDITORONLY_DATA
+	// Graph M_RallyBase is expected to have, for editor sessions where it has not been authored yet
+	UMaterialInterface* BuildTransientBaseMaterial()
+	{
+		UMaterial* Mat = NewObject<UMaterial>(GetTransientPackage(), TEXT("M_RallyBase_Transient"), RF_Transient);
+		Mat->MaterialDomain = MD_Surface;
+		Mat->bUsedWithInstancedStaticMeshes = true;
+
+		UMaterialExpressionVectorParameter* ColorParam = NewObject<UMaterialExpressionVectorParameter>(Mat);
+		ColorParam->ParameterName = FRallyMaterialLibrary::ColorParameter;
+		ColorParam->DefaultValue = FLinearColor::White;
+
+		UMaterialExpressionPerInstanceCustomData3Vector* InstanceColor =
+			NewObject<UMaterialExpressionPerInstanceCustomData3Vector>(Mat);
+		InstanceColor->DataIndex = 0;
+		InstanceColor->ConstDefaultValue = FLinearColor::White;
+
+		UMaterialExpressionMultiply* Multiply = NewObject<UMaterialExpressionMultiply>(Mat);
+		Multiply->A.Expression = ColorParam;
+		Multiply->B.Expression = InstanceColor;
+
+		UMaterialEditorOnlyData* EditorData = Mat->GetEditorOnlyData();
+		EditorData->ExpressionCollection.Expressions.Add(ColorParam);
+		EditorData->ExpressionCollection.Expressions.Add(InstanceColor);
+		EditorData->ExpressionCollection.Expressions.Add(Multiply);
+		EditorData->BaseColor.Expression = Multiply;
+
+		Mat->PreEditChange(nullptr);
+		Mat->PostEditChange();
+		return Mat;
+	}
+#endif
+}
+
+UMaterialInterface* FRallyMaterialLibrary::GetBaseMaterial()
+{
+	static UMaterialInterface* BaseMaterial = nullptr;
+	if (BaseMaterial) return BaseMaterial;
+
+	BaseMaterial = LoadObject<UMaterialInterface>(nullptr, BaseMaterialPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+
+#if WITH_EDITORONLY_DATA
+	if (!BaseMaterial)
+	{
+		BaseMaterial = BuildTransientBaseMaterial();
+		UE_LOG(LogTemp, Log, TEXT("MaterialLibrary: %s not found, built a transient base material"), BaseMaterialPath);
+	}
+#endif
+
+	if (!BaseMaterial)
+	{
+		// No color support, but still renders
+		BaseMaterial = LoadObject<UMaterialInterface>(nullptr,
+			TEXT("/Engine/BasicShapes/BasicShapeMaterial.BasicShapeMaterial"));
+		UE_LOG(LogTemp, Warning, TEXT("MaterialLibrary: %s not found, using BasicShapeMaterial (no color support)"),
+			BaseMaterialPath);
+	}
+
+	// Shared by every world in the process (PIE clients included)
+	if (BaseMaterial)
+	{
+		BaseMaterial->AddToRoot();
+	}
+	return BaseMaterial;
+}
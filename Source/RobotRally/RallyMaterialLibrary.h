@@ -0,0 +1,25 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UMaterialInterface;
+
+/**
+ * Process-wide parent material shared by the board and the robots.
+ * Base color = "Color" vector parameter x per-instance custom data (floats 0-2, white when absent):
+ * instanced tiles/walls/arrows are colored per instance, robots through dynamic instances.
+ */
+struct ROBOTRALLY_API FRallyMaterialLibrary
+{
+	// Parent material asset, loaded once. In editor builds a missing asset is replaced by an
+	// equivalent transient material (compiled once per process); otherwise BasicShapeMaterial.
+	static UMaterialInterface* GetBaseMaterial();
+
+	// Vector parameter tinting the base color
+	static const FName ColorParameter;
+
+	// Asset looked up first. Only loaded by path, so its directory is always cooked (DefaultGame.ini).
+	static const TCHAR* BaseMaterialPath;
+};
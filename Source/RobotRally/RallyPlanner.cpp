@@ -0,0 +1,349 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#include "RallyPlanner.h"
+#include "RobotRallyGameMode.h"
+#include "HAL/PlatformTime.h"
+
+namespace RallyPlannerScoring
+{
+	constexpr float CheckpointWeight = 1000.0f;
+	constexpr float WinBonus = 100000.0f;
+	constexpr float DeathPenalty = 1000000.0f;
+	constexpr float LifePenalty = 5000.0f;
+	constexpr float DamagePenalty = 50.0f;
+	constexpr float DistanceWeight = 10.0f;
+	constexpr float FacingBonus = 5.0f;
+
+	// Move3 plus one conveyor tile
+	constexpr int32 MaxStepsPerRegister = 4;
+
+	// Check the clock every N nodes
+	constexpr int32 TimeCheckInterval = 64;
+}
+
+using namespace RallyPlannerScoring;
+
+// Forward moves first so good programs are found early and pruning bites sooner
+static const ECardAction PlannerActionOrder[] =
+{
+	ECardAction::Move3,
+	ECardAction::Move2,
+	ECardAction::Move1,
+	ECardAction::RotateRight,
+	ECardAction::RotateLeft,
+	ECardAction::UTurn,
+	ECardAction::MoveBack
+};
+
+FRallyPlanner::FRallyPlanner(const FRallySimulator& InStart, int32 InRobotIndex)
+	: Start(InStart)
+	, Grid(InStart.GetGrid())
+	, RobotIndex(InRobotIndex)
+	, StartRobot(InStart.GetRobot(InRobotIndex))
+	, UnreachableDistance(FMath::Max(1, InStart.GetGrid().Width * InStart.GetGrid().Height))
+{
+}
+
+FRallyPlanResult FRallyPlanner::Plan(TConstArrayView<FRallyCard> Hand, double TimeBudgetSeconds, int32 NodeBudget)
+{
+	FRallyPlanResult Result;
+
+	const int32 NumRegisters = FMath::Min(Hand.Num(), FRallySimulator::NUM_REGISTERS);
+	if (NumRegisters == 0 || !StartRobot.bAlive) return Result;
+
+	FActionCounts Counts = 0;
+	for (const FRallyCard& Card : Hand)
+	{
+		const int32 Action = static_cast<int32>(Card.Action);
+		if (GetCount(Counts, Action) < 0xF)
+		{
+			Counts += 1u << (Action * 4);
+		}
+	}
+
+	Memo.Reset();
+	BestScore = 0.0f;
+	bHasBest = false;
+	bOutOfBudget = false;
+	NodesVisited = 0;
+	MemoHits = 0;
+	Deadline = TimeBudgetSeconds > 0.0 ? FPlatformTime::Seconds() + TimeBudgetSeconds : 0.0;
+	MaxNodes = FMath::Max(0, NodeBudget);
+
+	// A short hand fills fewer registers
+	FMemoEntry Root;
+	Search(Start, Counts, FRallySimulator::NUM_REGISTERS - NumRegisters, Root);
+
+	// Map the chosen actions back to hand cards (highest priority first among equals)
+	TArray<bool, TInlineAllocator<16>> bUsed;
+	bUsed.Init(false, Hand.Num());
+
+	for (int32 i = 0; i < Root.NumActions && Result.HandIndices.Num() < NumRegisters; ++i)
+	{
+		int32 BestIndex = INDEX_NONE;
+		for (int32 h = 0; h < Hand.Num(); ++h)
+		{
+			if (bUsed[h] || static_cast<uint8>(Hand[h].Action) != Root.Actions[i]) continue;
+			if (BestIndex == INDEX_NONE || Hand[h].Priority > Hand[BestIndex].Priority)
+			{
+				BestIndex = h;
+			}
+		}
+		if (BestIndex == INDEX_NONE) break;
+
+		bUsed[BestIndex] = true;
+		Result.HandIndices.Add(BestIndex);
+	}
+
+	// Robot died early or the budget ran out: fill the remaining registers in hand order
+	for (int32 h = 0; h < Hand.Num() && Result.HandIndices.Num() < NumRegisters; ++h)
+	{
+		if (!bUsed[h])
+		{
+			bUsed[h] = true;
+			Result.HandIndices.Add(h);
+		}
+	}
+
+	Result.Score = Root.Value;
+	Result.NodesVisited = NodesVisited;
+	Result.MemoHits = MemoHits;
+	Result.bCompleted = !bOutOfBudget;
+	return Result;
+}
+
+void FRallyPlanner::Search(const FRallySimulator& Sim, FActionCounts Remaining, int32 Depth, FMemoEntry& OutEntry)
+{
+	++NodesVisited;
+	if (MaxNodes > 0 && NodesVisited >= MaxNodes)
+	{
+		bOutOfBudget = true;
+	}
+	else if (Deadline > 0.0 && NodesVisited % TimeCheckInterval == 0 && FPlatformTime::Seconds() > Deadline)
+	{
+		bOutOfBudget = true;
+	}
+
+	const FRallyRobotState& Robot = Sim.GetRobot(RobotIndex);
+
+	// Leaf: program complete, robot gone or game decided
+	if (Depth >= FRallySimulator::NUM_REGISTERS || Remaining == 0 || !Robot.bAlive || Sim.IsGameOver() || bOutOfBudget)
+	{
+		OutEntry.Value = Evaluate(Robot);
+		OutEntry.bExact = true;
+		OutEntry.NumActions = 0;
+
+		if (!bOutOfBudget && (!bHasBest || OutEntry.Value > BestScore))
+		{
+			BestScore = OutEntry.Value;
+			bHasBest = true;
+		}
+		return;
+	}
+
+	const FMemoKey Key = MakeKey(Sim, Remaining);
+	if (const FMemoEntry* Found = Memo.Find(Key))
+	{
+		// Upper bounds only stay useful while they are below the best score
+		if (Found->bExact || Found->Value <= BestScore)
+		{
+			++MemoHits;
+			OutEntry = *Found;
+			return;
+		}
+	}
+
+	const int32 RegistersLeft = FRallySimulator::NUM_REGISTERS - Depth;
+	if (bHasBest)
+	{
+		const float Bound = UpperBound(Robot, RegistersLeft);
+		if (Bound <= BestScore)
+		{
+			OutEntry.Value = Bound;
+			OutEntry.bExact = false;
+			OutEntry.NumActions = 0;
+			Memo.Add(Key, OutEntry);
+			return;
+		}
+	}
+
+	float BestExact = -MAX_flt;
+	float MaxCutBound = -MAX_flt;
+	OutEntry.NumActions = 0;
+
+	for (ECardAction Action : PlannerActionOrder)
+	{
+		const int32 ActionIndex = static_cast<int32>(Action);
+		if (GetCount(Remaining, ActionIndex) == 0) continue;
+
+		FRallySimulator Child = Sim;
+		Child.ExecuteCard(RobotIndex, { Action, 0 });
+		Child.ResolveBoardElements();
+
+		FMemoEntry ChildEntry;
+		Search(Child, Remaining - (1u << (ActionIndex * 4)), Depth + 1, ChildEntry);
+
+		if (!ChildEntry.bExact)
+		{
+			MaxCutBound = FMath::Max(MaxCutBound, ChildEntry.Value);
+		}
+		else if (ChildEntry.Value > BestExact)
+		{
+			BestExact = ChildEntry.Value;
+			OutEntry.Actions[0] = static_cast<uint8>(ActionIndex);
+			FMemory::Memcpy(&OutEntry.Actions[1], ChildEntry.Actions, ChildEntry.NumActions);
+			OutEntry.NumActions = 1 + ChildEntry.NumActions;
+		}
+
+		if (bOutOfBudget) break;
+	}
+
+	OutEntry.bExact = BestExact >= MaxCutBound;
+	OutEntry.Value = FMath::Max(BestExact, MaxCutBound);
+
+	// A partial search proves nothing about this state
+	if (!bOutOfBudget)
+	{
+		Memo.Add(Key, OutEntry);
+	}
+}
+
+float FRallyPlanner::Evaluate(const FRallyRobotState& Robot)
+{
+	if (!Robot.bAlive) return -DeathPenalty;
+
+	float Score = Robot.Checkpoint * CheckpointWeight;
+
+	const int32 TotalCheckpoints = Start.GetTotalCheckpoints();
+	if (TotalCheckpoints > 0 && Robot.Checkpoint >= TotalCheckpoints)
+	{
+		return Score + WinBonus;
+	}
+
+	// Respawning restores health, so only count damage within the same life
+	const int32 LivesLost = StartRobot.Lives - Robot.Lives;
+	Score -= LivesLost * LifePenalty;
+	if (LivesLost == 0)
+	{
+		Score -= (StartRobot.Health - Robot.Health) * DamagePenalty;
+	}
+
+	const int32 Distance = GetDistance(Robot.Checkpoint + 1, Robot.X, Robot.Y);
+	Score -= Distance * DistanceWeight;
+
+	// Prefer ending the program facing along the path
+	int32 DX, DY;
+	FRallySimulator::GetDirectionDelta(Robot.Facing, DX, DY);
+	const int32 AheadX = Robot.X + DX;
+	const int32 AheadY = Robot.Y + DY;
+	if (Grid.IsInBounds(AheadX, AheadY) && !Grid.IsMovementBlocked(Robot.X, Robot.Y, AheadX, AheadY) &&
+		GetDistance(Robot.Checkpoint + 1, AheadX, AheadY) < Distance)
+	{
+		Score += FacingBonus;
+	}
+
+	return Score;
+}
+
+float FRallyPlanner::UpperBound(const FRallyRobotState& Robot, int32 RegistersLeft)
+{
+	if (!Robot.bAlive) return Evaluate(Robot);
+
+	const int32 TotalCheckpoints = Start.GetTotalCheckpoints();
+	if (TotalCheckpoints > 0 && Robot.Checkpoint >= TotalCheckpoints) return Evaluate(Robot);
+
+	// Close enough to collect the next checkpoint: no useful bound
+	const int32 Distance = GetDistance(Robot.Checkpoint + 1, Robot.X, Robot.Y);
+	const int32 BestDistance = Distance - RegistersLeft * MaxStepsPerRegister;
+	if (BestDistance <= 0) return MAX_flt;
+
+	const int32 LivesLost = StartRobot.Lives - Robot.Lives;
+	float Base = Robot.Checkpoint * CheckpointWeight - LivesLost * LifePenalty;
+	if (LivesLost == 0)
+	{
+		Base -= (StartRobot.Health - Robot.Health) * DamagePenalty;
+	}
+
+	// Either keep walking, or die and respawn somewhere closer
+	const float Walking = Base - BestDistance * DistanceWeight + FacingBonus;
+	const float Respawning = Robot.Checkpoint * CheckpointWeight - (LivesLost + 1) * LifePenalty + FacingBonus;
+	return FMath::Max(Walking, Respawning);
+}
+
+int32 FRallyPlanner::GetDistance(int32 Number, int32 X, int32 Y)
+{
+	if (!Grid.IsInBounds(X, Y)) return UnreachableDistance;
+
+	const int32 Goal = Grid.FindCheckpoint(Number);
+	if (Goal == INDEX_NONE) return 0;
+
+	TArray<int32>* Field = DistanceFields.Find(Number);
+	if (!Field)
+	{
+		// Breadth-first search out from the checkpoint
+		Field = &DistanceFields.Add(Number);
+		Field->Init(UnreachableDistance, Grid.Tiles.Num());
+
+		TArray<int32> Frontier;
+		Frontier.Reserve(Grid.Tiles.Num());
+		(*Field)[Goal] = 0;
+		Frontier.Add(Goal);
+
+		for (int32 Head = 0; Head < Frontier.Num(); ++Head)
+		{
+			const FIntVector Cur = Grid.FromIndex(Frontier[Head]);
+			const int32 NextDistance = (*Field)[Frontier[Head]] + 1;
+
+			for (uint8 Dir = 0; Dir < 4; ++Dir)
+			{
+				int32 DX, DY;
+				FRallySimulator::GetDirectionDelta(Dir, DX, DY);
+				const int32 NX = Cur.X + DX;
+				const int32 NY = Cur.Y + DY;
+
+				if (!Grid.IsInBounds(NX, NY) || Grid.GetTileType(NX, NY) == ETileType::Pit) continue;
+				if (Grid.IsMovementBlocked(NX, NY, Cur.X, Cur.Y)) continue;
+
+				const int32 NIndex = Grid.ToIndex(NX, NY);
+				if ((*Field)[NIndex] <= NextDistance) continue;
+
+				(*Field)[NIndex] = NextDistance;
+				Frontier.Add(NIndex);
+			}
+		}
+	}
+
+	return (*Field)[Grid.ToIndex(X, Y)];
+}
+
+FRallyPlanner::FMemoKey FRallyPlanner::MakeKey(const FRallySimulator& Sim, FActionCounts Remaining) const
+{
+	const FRallyRobotState& Robot = Sim.GetRobot(RobotIndex);
+
+	FMemoKey Key;
+	Key.Remaining = Remaining;
+	Key.Self = static_cast<uint64>(Robot.X & 0xFF)
+		| (static_cast<uint64>(Robot.Y & 0xFF) << 8)
+		| (static_cast<uint64>(Robot.Facing & 0x3) << 16)
+		| (static_cast<uint64>(Robot.Health & 0x3F) << 18)
+		| (static_cast<uint64>(Robot.Lives & 0xF) << 24)
+		| (static_cast<uint64>(Robot.Checkpoint & 0x3F) << 28)
+		| (static_cast<uint64>(Robot.bAlive) << 34)
+		| (static_cast<uint64>(Robot.RespawnX & 0xFF) << 35)
+		| (static_cast<uint64>(Robot.RespawnY & 0xFF) << 43)
+		| (static_cast<uint64>(Sim.IsGameOver()) << 51);
+
+	// Other robots only move when pushed or carried; a hash is enough to tell states apart
+	uint32 Others = 0;
+	for (int32 i = 0; i < Sim.NumRobots(); ++i)
+	{
+		if (i == RobotIndex) continue;
+
+		const FRallyRobotState& Other = Sim.GetRobot(i);
+		Others = HashCombine(Others, GetTypeHash(Other.X | (Other.Y << 8) | (Other.Facing << 16) | (Other.bAlive << 18)));
+		Others = HashCombine(Others, GetTypeHash(Other.Health | (Other.Lives << 8) | (Other.Checkpoint << 16)));
+	}
+	Key.Others = Others;
+
+	return Key;
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RallySimulator.h"
+
+struct FRallyPlanResult
+{
+	// Hand indices in register order (empty if no plan was found)
+	TArray<int32, TInlineAllocator<FRallySimulator::NUM_REGISTERS>> HandIndices;
+
+	float Score = 0.0f;
+	int32 NodesVisited = 0;
+	int32 MemoHits = 0;
+
+	// False if the time or node budget ran out before the search space was exhausted
+	bool bCompleted = false;
+};
+
+/**
+ * Self-contained copy of the board and robots. Immutable once built, so planning
+ * tasks on worker threads can share it while the game thread keeps changing the world.
+ */
+struct ROBOTRALLY_API FRallyPlanningSnapshot
+{
+	explicit FRallyPlanningSnapshot(const FRallySimulator& Source)
+		: Grid(Source.GetGrid())
+		, Sim(Source, Grid)
+	{
+	}
+
+	const FTileGrid Grid;
+	const FRallySimulator Sim;
+};
+
+/**
+ * Searches ordered register selections from a hand (9P5 = 15,120 for a full hand)
+ * by running each card through FRallySimulator. Other robots stand still.
+ * Cards with the same action are interchangeable, so equal actions are only expanded once;
+ * subtrees are cut by an optimistic distance bound and intermediate states are memoized.
+ */
+class ROBOTRALLY_API FRallyPlanner
+{
+public:
+	// Start must be a snapshot of the current board; its grid must outlive the planner
+	FRallyPlanner(const FRallySimulator& InStart, int32 InRobotIndex);
+
+	// Stops at whichever budget runs out first; 0 disables a budget. The node budget gives
+	// the same plan on every run and machine (batch simulation), the time budget does not.
+	FRallyPlanResult Plan(TConstArrayView<FRallyCard> Hand, double TimeBudgetSeconds, int32 NodeBudget = 0);
+
+private:
+	static constexpr int32 NUM_ACTIONS = 7;
+
+	// Remaining cards as per-action counts, 4 bits per action
+	using FActionCounts = uint32;
+
+	struct FMemoKey
+	{
+		uint64 Self = 0;
+		uint32 Others = 0;
+		FActionCounts Remaining = 0;
+
+		bool operator==(const FMemoKey& Other) const
+		{
+			return Self == Other.Self && Others == Other.Others && Remaining == Other.Remaining;
+		}
+
+		friend uint32 GetTypeHash(const FMemoKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.Self), Key.Others), Key.Remaining);
+		}
+	};
+
+	struct FMemoEntry
+	{
+		float Value = 0.0f;
+
+		// False: the subtree was cut, Value is only an upper bound
+		bool bExact = false;
+
+		// Best continuation from this state
+		uint8 NumActions = 0;
+		uint8 Actions[FRallySimulator::NUM_REGISTERS] = {};
+	};
+
+	// Best leaf score reachable from Sim; fills OutEntry with the continuation
+	void Search(const FRallySimulator& Sim, FActionCounts Remaining, int32 Depth, FMemoEntry& OutEntry);
+
+	float Evaluate(const FRallyRobotState& Robot);
+
+	// Optimistic score for any continuation with RegistersLeft more cards
+	float UpperBound(const FRallyRobotState& Robot, int32 RegistersLeft);
+
+	// Walking distance (walls and pits respected) from (X, Y) to checkpoint Number
+	int32 GetDistance(int32 Number, int32 X, int32 Y);
+
+	FMemoKey MakeKey(const FRallySimulator& Sim, FActionCounts Remaining) const;
+
+	static int32 GetCount(FActionCounts Counts, int32 Action) { return (Counts >> (Action * 4)) & 0xF; }
+
+	const FRallySimulator& Start;
+	const FTileGrid& Grid;
+	int32 RobotIndex;
+	FRallyRobotState StartRobot;
+	int32 UnreachableDistance;
+
+	// Checkpoint number -> distance field over Grid.Tiles
+	TMap<int32, TArray<int32>> DistanceFields;
+
+	TMap<FMemoKey, FMemoEntry> Memo;
+
+	// Highest leaf score found so far (search-wide pruning threshold)
+	float BestScore = 0.0f;
+	bool bHasBest = false;
+
+	double Deadline = 0.0;
+	int32 MaxNodes = 0;
+	bool bOutOfBudget = false;
+	int32 NodesVisited = 0;
+	int32 MemoHits = 0;
+};
@@ -0,0 +1,337 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#include "RallyReplay.h"
+#include "RobotRallyGameMode.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/BitReader.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+
+namespace RallyReplay
+{
+	static constexpr uint32 Magic = 0x4C505252;  // "RRPL"
+	static constexpr uint32 Version = 1;
+	static constexpr uint32 NumCardActions = static_cast<uint32>(ECardAction::UTurn) + 1;
+	static constexpr uint32 MaxRobots = 255;
+	static constexpr uint32 MaxRounds = 65536;
+	static constexpr uint32 MaxBoardBytes = 4 + 3 * 256 * 256;
+
+	// Zigzag + packed: small values of either sign take one byte
+	static void SerializeSigned(FArchive& Ar, int32& Value)
+	{
+		uint32 Packed = (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+		Ar.SerializeIntPacked(Packed);
+		if (Ar.IsLoading())
+		{
+			Value = static_cast<int32>(Packed >> 1) ^ -static_cast<int32>(Packed & 1);
+		}
+	}
+
+	static void SerializeBool(FArchive& Ar, bool& bValue)
+	{
+		uint8 Bit = bValue ? 1 : 0;
+		Ar.SerializeBits(&Bit, 1);
+		bValue = Bit != 0;
+	}
+
+	static void SerializeRobotState(FArchive& Ar, FRallyRobotState& State)
+	{
+		SerializeSigned(Ar, State.X);
+		SerializeSigned(Ar, State.Y);
+
+		uint32 Facing = State.Facing & 3;
+		Ar.SerializeInt(Facing, 4);
+		State.Facing = static_cast<uint8>(Facing);
+
+		SerializeSigned(Ar, State.Health);
+		SerializeSigned(Ar, State.MaxHealth);
+		SerializeSigned(Ar, State.Lives);
+		SerializeSigned(Ar, State.Checkpoint);
+		SerializeSigned(Ar, State.RespawnX);
+		SerializeSigned(Ar, State.RespawnY);
+		SerializeBool(Ar, State.bAlive);
+	}
+
+	// 3 bits for the card count, then 3 bits of action plus a packed priority per card
+	static void SerializeProgram(FArchive& Ar, FRallyProgram& Program)
+	{
+		uint32 NumCards = FMath::Min(Program.Cards.Num(), FRallySimulator::NUM_REGISTERS);
+		Ar.SerializeInt(NumCards, FRallySimulator::NUM_REGISTERS + 1);
+		if (Ar.IsLoading())
+		{
+			Program.Cards.SetNum(NumCards);
+		}
+
+		for (uint32 i = 0; i < NumCards; ++i)
+		{
+			FRallyCard& Card = Program.Cards[i];
+
+			uint32 Action = static_cast<uint32>(Card.Action);
+			Ar.SerializeInt(Action, NumCardActions);
+			Card.Action = static_cast<ECardAction>(Action);
+
+			uint32 Priority = static_cast<uint32>(FMath::Max(0, Card.Priority));
+			Ar.SerializeIntPacked(Priority);
+			Card.Priority = static_cast<int32>(Priority);
+		}
+	}
+
+	static void GetRobotStates(const FRallySimulator& Sim, TArray<FRallyRobotState>& OutStates)
+	{
+		OutStates.Reset(Sim.NumRobots());
+		for (int32 i = 0; i < Sim.NumRobots(); ++i)
+		{
+			OutStates.Add(Sim.GetRobot(i));
+		}
+	}
+}
+
+void FRallyReplay::BeginRecording(int32 InMatchSeed, const FRallySimulator& Sim)
+{
+	MatchSeed = InMatchSeed;
+	Sim.GetGrid().WriteBoardBlob(BoardBlob);
+	BoardHash = FTileGrid::HashBoardBlob(BoardBlob);
+	TotalCheckpoints = Sim.GetTotalCheckpoints();
+
+	Robots.Reset(Sim.NumRobots());
+	for (int32 i = 0; i < Sim.NumRobots(); ++i)
+	{
+		Robots.AddDefaulted_GetRef().State = Sim.GetRobot(i);
+	}
+
+	Rounds.Reset();
+	RallyReplay::GetRobotStates(Sim, ExpectedRobots);
+}
+
+void FRallyReplay::RecordRound(const FRallySimulator& Sim)
+{
+	FRallyReplayRound& Round = Rounds.AddDefaulted_GetRef();
+
+	TArray<FRallyRobotState> Current;
+	RallyReplay::GetRobotStates(Sim, Current);
+	if (Current != ExpectedRobots)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Replay: robots differ from the rules before round %d, recording a keyframe"),
+			Rounds.Num());
+		Round.Keyframe = Current;
+	}
+
+	Round.Programs.SetNum(Sim.NumRobots());
+	for (int32 i = 0; i < Sim.NumRobots(); ++i)
+	{
+		if (Sim.GetRobot(i).bAlive)
+		{
+			Round.Programs[i] = Sim.GetProgram(i);
+		}
+	}
+
+	// Predict the next round's starting state so drift is caught there
+	FRallySimulator Next(Sim, Sim.GetGrid());
+	Next.ResolveRound();
+	RallyReplay::GetRobotStates(Next, ExpectedRobots);
+}
+
+bool FRallyReplay::BuildGrid(FTileGrid& OutGrid) const
+{
+	return FTileGrid::HashBoardBlob(BoardBlob) == BoardHash && OutGrid.InitFromBoardBlob(BoardBlob);
+}
+
+FRallySimulator FRallyReplay::CreateSimulator(const FTileGrid& Grid) const
+{
+	FRallySimulator Sim(Grid, TotalCheckpoints);
+	for (const FRallyReplayRobot& Robot : Robots)
+	{
+		Sim.AddRobot(Robot.State);
+	}
+	return Sim;
+}
+
+void FRallyReplay::ResolveRound(FRallySimulator& Sim, int32 RoundIndex, TArray<FRallyEvent>* OutEvents) const
+{
+	if (!Rounds.IsValidIndex(RoundIndex)) return;
+
+	const FRallyReplayRound& Round = Rounds[RoundIndex];
+	for (int32 i = 0; i < Round.Keyframe.Num() && i < Sim.NumRobots(); ++i)
+	{
+		Sim.SetRobot(i, Round.Keyframe[i]);
+	}
+
+	for (int32 i = 0; i < Sim.NumRobots(); ++i)
+	{
+		Sim.SetProgram(i, Round.Programs.IsValidIndex(i) ? Round.Programs[i] : FRallyProgram());
+	}
+
+	Sim.ResolveRound(OutEvents);
+}
+
+bool FRallyReplay::PlayHeadless(FRallyReplayResult& OutResult, FString& OutError) const
+{
+	FTileGrid Grid;
+	if (!BuildGrid(Grid))
+	{
+		OutError = FString::Printf(TEXT("Board does not match hash %016llx"), BoardHash);
+		return false;
+	}
+
+	FRallySimulator Sim = CreateSimulator(Grid);
+
+	OutResult = FRallyReplayResult();
+	for (int32 RoundIndex = 0; RoundIndex < Rounds.Num() && !Sim.IsGameOver(); ++RoundIndex)
+	{
+		if (Rounds[RoundIndex].Keyframe.Num() > 0)
+		{
+			OutResult.Keyframes++;
+		}
+		ResolveRound(Sim, RoundIndex);
+		OutResult.RoundsPlayed++;
+	}
+
+	OutResult.bGameOver = Sim.IsGameOver();
+	OutResult.Winner = Sim.GetWinner();
+	RallyReplay::GetRobotStates(Sim, OutResult.FinalRobots);
+	return true;
+}
+
+bool FRallyReplay::SaveToFile(const FString& Path) const
+{
+	TArray<uint8> Bytes;
+	return SaveToBytes(Bytes) && FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FRallyReplay::SaveToBytes(TArray<uint8>& OutBytes) const
+{
+	FBitWriter Writer(0, true);
+	const_cast<FRallyReplay*>(this)->Serialize(Writer);
+	if (Writer.IsError()) return false;
+
+	OutBytes.Reset(Writer.GetNumBytes());
+	OutBytes.Append(Writer.GetData(), Writer.GetNumBytes());
+	return true;
+}
+
+bool FRallyReplay::LoadFromFile(const FString& Path, FString& OutError)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+	{
+		OutError = FString::Printf(TEXT("Cannot read %s"), *Path);
+		return false;
+	}
+
+	FBitReader Reader(Bytes.GetData(), Bytes.Num() * 8);
+	FRallyReplay Loaded;
+	if (!Loaded.Serialize(Reader))
+	{
+		OutError = FString::Printf(TEXT("%s is not a valid replay"), *Path);
+		return false;
+	}
+
+	*this = MoveTemp(Loaded);
+	return true;
+}
+
+FString FRallyReplay::MakeRecordingPath(int32 InMatchSeed)
+{
+	return FPaths::ProjectSavedDir() / TEXT("Replays")
+		/ FString::Printf(TEXT("%s_%d.rreplay"), *FDateTime::Now().ToString(), InMatchSeed);
+}
+
+void FRallyReplay::PruneRecordings(int32 MaxKept)
+{
+	const FString Dir = FPaths::ProjectSavedDir() / TEXT("Replays");
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(Dir / TEXT("*.rreplay")), true, false);
+	if (Files.Num() <= MaxKept) return;
+
+	// Oldest first
+	TArray<TPair<FDateTime, FString>> ByAge;
+	for (const FString& File : Files)
+	{
+		const FString Path = Dir / File;
+		ByAge.Emplace(IFileManager::Get().GetTimeStamp(*Path), Path);
+	}
+	ByAge.Sort([](const TPair<FDateTime, FString>& A, const TPair<FDateTime, FString>& B) { return A.Key < B.Key; });
+
+	for (int32 i = 0; i < ByAge.Num() - FMath::Max(0, MaxKept); ++i)
+	{
+		IFileManager::Get().Delete(*ByAge[i].Value);
+	}
+}
+
+bool FRallyReplay::Serialize(FArchive& Ar)
+{
+	using namespace RallyReplay;
+
+	uint32 FileMagic = Magic;
+	uint32 FileVersion = Version;
+	Ar << FileMagic;
+	Ar.SerializeIntPacked(FileVersion);
+	if (Ar.IsError() || FileMagic != Magic || FileVersion != Version) return false;
+
+	Ar << MatchSeed;
+	Ar << BoardHash;
+
+	uint32 BoardBytes = BoardBlob.Num();
+	Ar.SerializeIntPacked(BoardBytes);
+	if (Ar.IsLoading())
+	{
+		if (Ar.IsError() || BoardBytes > MaxBoardBytes) return false;
+		BoardBlob.SetNumUninitialized(BoardBytes);
+	}
+	Ar.Serialize(BoardBlob.GetData(), BoardBytes);
+	SerializeSigned(Ar, TotalCheckpoints);
+
+	uint32 NumRobots = FMath::Min<uint32>(Robots.Num(), MaxRobots);
+	Ar.SerializeInt(NumRobots, MaxRobots + 1);
+	if (Ar.IsLoading())
+	{
+		Robots.SetNum(NumRobots);
+	}
+	for (uint32 i = 0; i < NumRobots; ++i)
+	{
+		FRallyReplayRobot& Robot = Robots[i];
+		SerializeRobotState(Ar, Robot.State);
+		Ar << Robot.ControllerType;
+		Ar << Robot.BodyColor;
+	}
+
+	uint32 NumRounds = Rounds.Num();
+	Ar.SerializeIntPacked(NumRounds);
+	if (Ar.IsLoading())
+	{
+		if (Ar.IsError() || NumRounds > MaxRounds) return false;
+		Rounds.SetNum(NumRounds);
+	}
+
+	for (FRallyReplayRound& Round : Rounds)
+	{
+		bool bHasKeyframe = Round.Keyframe.Num() > 0;
+		SerializeBool(Ar, bHasKeyframe);
+		if (bHasKeyframe)
+		{
+			if (Ar.IsLoading())
+			{
+				Round.Keyframe.SetNum(NumRobots);
+			}
+			for (FRallyRobotState& State : Round.Keyframe)
+			{
+				SerializeRobotState(Ar, State);
+			}
+		}
+
+		if (Ar.IsLoading())
+		{
+			Round.Programs.SetNum(NumRobots);
+		}
+		for (FRallyProgram& Program : Round.Programs)
+		{
+			SerializeProgram(Ar, Program);
+		}
+
+		if (Ar.IsError()) return false;
+	}
+
+	return !Ar.IsError();
+}
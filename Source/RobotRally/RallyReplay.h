@@ -0,0 +1,89 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RallySimulator.h"
+
+// Starting state of one recorded robot
+struct FRallyReplayRobot
+{
+	FRallyRobotState State;
+	uint8 ControllerType = 0;  // ERobotControllerType value
+	FColor BodyColor = FColor::White;
+};
+
+// One round of a recorded match
+struct FRallyReplayRound
+{
+	// Committed program per robot (empty for dead or unprogrammed robots)
+	TArray<FRallyProgram> Programs;
+
+	// Every robot's state before the round; only recorded when the match drifted from the rules
+	// (e.g. debug moves between rounds), empty otherwise
+	TArray<FRallyRobotState> Keyframe;
+};
+
+// Outcome of replaying a match without actors
+struct FRallyReplayResult
+{
+	int32 RoundsPlayed = 0;
+	int32 Keyframes = 0;
+	bool bGameOver = false;
+	int32 Winner = INDEX_NONE;
+	TArray<FRallyRobotState> FinalRobots;
+};
+
+/**
+ * Compact match recording: seed, board, starting robots and each round's committed programs.
+ * Bit-packed on disk (a few bytes per robot and round); playback re-runs the rules with
+ * FRallySimulator, either instantly or animated by the GameMode.
+ */
+class ROBOTRALLY_API FRallyReplay
+{
+public:
+	int32 MatchSeed = 0;
+	uint64 BoardHash = 0;
+	TArray<uint8> BoardBlob;
+	int32 TotalCheckpoints = 0;
+	TArray<FRallyReplayRobot> Robots;
+	TArray<FRallyReplayRound> Rounds;
+
+	// Writer: take the board and robots of Sim as the start of the match
+	void BeginRecording(int32 InMatchSeed, const FRallySimulator& Sim);
+
+	// Writer: append the round Sim is about to resolve. Adds a keyframe if Sim's robots
+	// differ from what the rules predicted after the previous round.
+	void RecordRound(const FRallySimulator& Sim);
+
+	// Recorded board; false if the blob is corrupt or doesn't match BoardHash
+	bool BuildGrid(FTileGrid& OutGrid) const;
+
+	// Simulator at the start of the match (Grid must outlive it)
+	FRallySimulator CreateSimulator(const FTileGrid& Grid) const;
+
+	// Apply round RoundIndex (keyframe, then programs) to Sim and resolve it
+	void ResolveRound(FRallySimulator& Sim, int32 RoundIndex, TArray<FRallyEvent>* OutEvents = nullptr) const;
+
+	// Re-run the whole match instantly
+	bool PlayHeadless(FRallyReplayResult& OutResult, FString& OutError) const;
+
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path, FString& OutError);
+
+	// Encoded file contents, for writing elsewhere (e.g. off the game thread)
+	bool SaveToBytes(TArray<uint8>& OutBytes) const;
+
+	// Default location for a new recording: Saved/Replays/<timestamp>_<seed>.rreplay
+	static FString MakeRecordingPath(int32 InMatchSeed);
+
+	// Delete the oldest recordings in Saved/Replays until at most MaxKept remain
+	static void PruneRecordings(int32 MaxKept);
+
+private:
+	// Symmetric bit-packed read/write; false on a malformed stream
+	bool Serialize(FArchive& Ar);
+
+	// Writer: robot states the rules predict after the last recorded round
+	TArray<FRallyRobotState> ExpectedRobots;
+};
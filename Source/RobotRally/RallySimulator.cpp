@@ -0,0 +1,496 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#include "RallySimulator.h"
+#include "RobotRallyGameMode.h"
+
+FRallySimulator::FRallySimulator(const FTileGrid& InGrid, int32 InTotalCheckpoints)
+	: Grid(&InGrid)
+	, TotalCheckpoints(InTotalCheckpoints)
+{
+}
+
+FRallySimulator::FRallySimulator(const FRallySimulator& Other, const FTileGrid& InGrid)
+	: FRallySimulator(Other)
+{
+	Grid = &InGrid;
+	Events = nullptr;
+}
+
+int32 FRallySimulator::AddRobot(const FRallyRobotState& State)
+{
+	Programs.AddDefaulted();
+	return Robots.Add(State);
+}
+
+void FRallySimulator::SetProgram(int32 RobotIndex, const FRallyProgram& Program)
+{
+	if (Programs.IsValidIndex(RobotIndex))
+	{
+		Programs[RobotIndex] = Program;
+	}
+}
+
+void FRallySimulator::SetRobot(int32 RobotIndex, const FRallyRobotState& State)
+{
+	if (Robots.IsValidIndex(RobotIndex))
+	{
+		Robots[RobotIndex] = State;
+	}
+}
+
+void FRallySimulator::GetDirectionDelta(uint8 Facing, int32& OutDX, int32& OutDY)
+{
+	// +X=North, +Y=East, -X=South, -Y=West
+	static constexpr int32 DeltaX[4] = { 1, 0, -1, 0 };
+	static constexpr int32 DeltaY[4] = { 0, 1, 0, -1 };
+	OutDX = DeltaX[Facing & 3];
+	OutDY = DeltaY[Facing & 3];
+}
+
+// ============================================================================
+// Public entry points
+// ============================================================================
+
+void FRallySimulator::ResolveRound(TArray<FRallyEvent>* OutEvents)
+{
+	Events = OutEvents;
+	for (int32 Register = 0; Register < NUM_REGISTERS && !bGameOver; ++Register)
+	{
+		ResolveRegisterInternal(Register);
+	}
+	Events = nullptr;
+}
+
+void FRallySimulator::ResolveRegister(int32 Register, TArray<FRallyEvent>* OutEvents)
+{
+	Events = OutEvents;
+	ResolveRegisterInternal(Register);
+	Events = nullptr;
+}
+
+void FRallySimulator::ExecuteCard(int32 RobotIndex, const FRallyCard& Card, TArray<FRallyEvent>* OutEvents)
+{
+	Events = OutEvents;
+	ExecuteCardInternal(RobotIndex, Card);
+	Events = nullptr;
+}
+
+void FRallySimulator::ResolveBoardElements(TArray<FRallyEvent>* OutEvents)
+{
+	Events = OutEvents;
+	ResolveBoardElementsInternal();
+	Events = nullptr;
+}
+
+// ============================================================================
+// Register resolution
+// ============================================================================
+
+void FRallySimulator::ResolveRegisterInternal(int32 Register)
+{
+	if (bGameOver) return;
+
+	CurrentRegister = Register;
+
+	// Collect this register's cards from all living robots
+	struct FQueuedCard
+	{
+		int32 Priority;
+		int32 RobotIndex;
+	};
+	TArray<FQueuedCard, TInlineAllocator<8>> Queue;
+
+	for (int32 i = 0; i < Robots.Num(); ++i)
+	{
+		if (!Robots[i].bAlive) continue;
+		if (!Programs[i].Cards.IsValidIndex(Register)) continue;
+
+		Queue.Add({ Programs[i].Cards[Register].Priority, i });
+	}
+
+	// Higher priority first
+	Queue.Sort([](const FQueuedCard& A, const FQueuedCard& B)
+	{
+		return A.Priority > B.Priority;
+	});
+
+	for (const FQueuedCard& Entry : Queue)
+	{
+		if (!Robots[Entry.RobotIndex].bAlive) continue;
+		ExecuteCardInternal(Entry.RobotIndex, Programs[Entry.RobotIndex].Cards[Register]);
+	}
+
+	Emit(ERallyEventType::BoardElements, 0);
+	ResolveBoardElementsInternal();
+
+	if (!bGameOver)
+	{
+		Emit(ERallyEventType::RegisterEnd, 0);
+	}
+}
+
+void FRallySimulator::ExecuteCardInternal(int32 RobotIndex, const FRallyCard& Card)
+{
+	if (!Robots.IsValidIndex(RobotIndex) || !Robots[RobotIndex].bAlive) return;
+
+	Emit(ERallyEventType::CardStart, RobotIndex, 0, 0, static_cast<int32>(Card.Action), Card.Priority);
+
+	switch (Card.Action)
+	{
+	case ECardAction::Move1:       MoveRobot(RobotIndex, 1);    break;
+	case ECardAction::Move2:       MoveRobot(RobotIndex, 2);    break;
+	case ECardAction::Move3:       MoveRobot(RobotIndex, 3);    break;
+	case ECardAction::MoveBack:    MoveRobot(RobotIndex, -1);   break;
+	case ECardAction::RotateRight: RotateRobot(RobotIndex, 1);  break;
+	case ECardAction::RotateLeft:  RotateRobot(RobotIndex, -1); break;
+	case ECardAction::UTurn:       RotateRobot(RobotIndex, 2);  break;
+	}
+}
+
+// ============================================================================
+// Movement
+// ============================================================================
+
+void FRallySimulator::MoveRobot(int32 RobotIndex, int32 Distance)
+{
+	int32 DX, DY;
+	GetDirectionDelta(Robots[RobotIndex].Facing, DX, DY);
+
+	// For MoveBack (Distance < 0), reverse direction
+	const int32 StepDir = (Distance >= 0) ? 1 : -1;
+	DX *= StepDir;
+	DY *= StepDir;
+
+	const int32 StartX = Robots[RobotIndex].X;
+	const int32 StartY = Robots[RobotIndex].Y;
+	const int32 AbsDistance = FMath::Abs(Distance);
+	int32 ValidSteps = 0;
+
+	for (int32 Step = 1; Step <= AbsDistance; ++Step)
+	{
+		const int32 FromX = StartX + DX * (Step - 1);
+		const int32 FromY = StartY + DY * (Step - 1);
+		const int32 NextX = StartX + DX * Step;
+		const int32 NextY = StartY + DY * Step;
+
+		// Walls block before anything else
+		if (Grid->IsMovementBlocked(FromX, FromY, NextX, NextY))
+		{
+			break;
+		}
+
+		// Robot in the way: push it in our movement direction
+		const int32 Blocker = FindRobotAt(NextX, NextY, RobotIndex);
+		if (Blocker != INDEX_NONE && !TryPushRobot(Blocker, DX, DY))
+		{
+			break;
+		}
+
+		if (!IsValidTile(NextX, NextY))
+		{
+			break;
+		}
+
+		ValidSteps = Step;
+	}
+
+	if (ValidSteps > 0)
+	{
+		FRallyRobotState& Robot = Robots[RobotIndex];
+		Robot.X = StartX + DX * ValidSteps;
+		Robot.Y = StartY + DY * ValidSteps;
+		Emit(ERallyEventType::Move, RobotIndex, Robot.X, Robot.Y);
+	}
+}
+
+void FRallySimulator::RotateRobot(int32 RobotIndex, int32 Steps)
+{
+	FRallyRobotState& Robot = Robots[RobotIndex];
+	Robot.Facing = static_cast<uint8>(((Robot.Facing + Steps) % 4 + 4) % 4);
+	Emit(ERallyEventType::Rotate, RobotIndex, Robot.X, Robot.Y, Steps, Robot.Facing);
+}
+
+bool FRallySimulator::TryPushRobot(int32 RobotIndex, int32 DX, int32 DY)
+{
+	const int32 FromX = Robots[RobotIndex].X;
+	const int32 FromY = Robots[RobotIndex].Y;
+	const int32 PushX = FromX + DX;
+	const int32 PushY = FromY + DY;
+
+	// Pits and hazards are OK - that's the point of pushing!
+	if (!Grid->IsInBounds(PushX, PushY))
+	{
+		return false;
+	}
+
+	if (Grid->IsMovementBlocked(FromX, FromY, PushX, PushY))
+	{
+		return false;
+	}
+
+	// Chain push
+	const int32 Blocker = FindRobotAt(PushX, PushY, RobotIndex);
+	if (Blocker != INDEX_NONE && !TryPushRobot(Blocker, DX, DY))
+	{
+		return false;
+	}
+
+	Robots[RobotIndex].X = PushX;
+	Robots[RobotIndex].Y = PushY;
+	Emit(ERallyEventType::Move, RobotIndex, PushX, PushY, 1);
+	return true;
+}
+
+int32 FRallySimulator::FindRobotAt(int32 X, int32 Y, int32 IgnoreIndex) const
+{
+	for (int32 i = 0; i < Robots.Num(); ++i)
+	{
+		const FRallyRobotState& Robot = Robots[i];
+		if (i != IgnoreIndex && Robot.bAlive && Robot.X == X && Robot.Y == Y)
+		{
+			return i;
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool FRallySimulator::IsValidTile(int32 X, int32 Y) const
+{
+	// Robots can enter any tile within bounds (pits kill in ResolveBoardElements)
+	return Grid->IsInBounds(X, Y);
+}
+
+// ============================================================================
+// Board elements
+// ============================================================================
+
+void FRallySimulator::ResolveBoardElementsInternal()
+{
+	// Tile effects, in robot order
+	for (int32 i = 0; i < Robots.Num(); ++i)
+	{
+		const FRallyRobotState& Robot = Robots[i];
+		if (!Robot.bAlive) continue;
+
+		const FPackedTile* Tile = Grid->Find(Robot.X, Robot.Y);
+		const ETileType Type = Tile ? Tile->TileType : ETileType::Pit;
+
+		switch (Type)
+		{
+		case ETileType::Pit:
+			Emit(ERallyEventType::PitFall, i, Robot.X, Robot.Y, 0, Robot.MaxHealth);
+			ApplyDamage(i, Robot.MaxHealth);
+			break;
+
+		case ETileType::Laser:
+			Emit(ERallyEventType::LaserHit, i, Robot.X, Robot.Y, 0, 1);
+			ApplyDamage(i, 1);
+			break;
+
+		case ETileType::Checkpoint:
+			ReachCheckpoint(i, Tile->CheckpointNumber);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	ResolveConveyors();
+
+	CheckWinLose();
+}
+
+void FRallySimulator::ResolveConveyors()
+{
+	// All belts move simultaneously: work out every robot's destination first
+	const int32 NumRobots = Robots.Num();
+	TArray<int32, TInlineAllocator<8>> From;
+	TArray<int32, TInlineAllocator<8>> Dest;
+	From.Init(INDEX_NONE, NumRobots);
+	Dest.Init(INDEX_NONE, NumRobots);
+
+	for (int32 i = 0; i < NumRobots; ++i)
+	{
+		const FRallyRobotState& Robot = Robots[i];
+		if (!Robot.bAlive || !Grid->IsInBounds(Robot.X, Robot.Y)) continue;
+
+		From[i] = Grid->ToIndex(Robot.X, Robot.Y);
+
+		const FConveyorLink& Link = Grid->ConveyorLinks[From[i]];
+		if (Link.bWallBlocked)
+		{
+			Emit(ERallyEventType::ConveyorBlocked, i, Robot.X, Robot.Y, 0);
+		}
+		Dest[i] = Link.NextIndex;
+	}
+
+	auto Cancel = [&](int32 i)
+	{
+		Emit(ERallyEventType::ConveyorBlocked, i, Robots[i].X, Robots[i].Y, 1);
+		Dest[i] = INDEX_NONE;
+	};
+
+	// Two robots carried onto the same tile: neither moves
+	TArray<bool, TInlineAllocator<8>> bContested;
+	bContested.Init(false, NumRobots);
+	for (int32 i = 0; i < NumRobots; ++i)
+	{
+		for (int32 j = i + 1; j < NumRobots && Dest[i] != INDEX_NONE; ++j)
+		{
+			if (Dest[j] == Dest[i])
+			{
+				bContested[i] = bContested[j] = true;
+			}
+		}
+	}
+	for (int32 i = 0; i < NumRobots; ++i)
+	{
+		if (bContested[i]) Cancel(i);
+	}
+
+	// A robot that stays put (or a head-on swap) blocks the move; cancellations can cascade
+	bool bChanged = true;
+	while (bChanged)
+	{
+		bChanged = false;
+		for (int32 i = 0; i < NumRobots; ++i)
+		{
+			if (Dest[i] == INDEX_NONE) continue;
+
+			for (int32 j = 0; j < NumRobots; ++j)
+			{
+				if (j == i || From[j] == INDEX_NONE || From[j] != Dest[i]) continue;
+
+				if (Dest[j] == INDEX_NONE || Dest[j] == From[i])
+				{
+					Cancel(i);
+					bChanged = true;
+					break;
+				}
+			}
+		}
+	}
+
+	// Apply moves and belt turns
+	for (int32 i = 0; i < NumRobots; ++i)
+	{
+		if (Dest[i] == INDEX_NONE) continue;
+
+		const FIntVector NewPos = Grid->FromIndex(Dest[i]);
+		Robots[i].X = NewPos.X;
+		Robots[i].Y = NewPos.Y;
+		Emit(ERallyEventType::ConveyorMove, i, NewPos.X, NewPos.Y);
+
+		const int8 Rotation = Grid->ConveyorLinks[From[i]].Rotation;
+		if (Rotation != 0)
+		{
+			RotateRobot(i, Rotation);
+		}
+	}
+
+	// Checkpoints reached and pits fallen into by being carried onto them
+	for (int32 i = 0; i < NumRobots; ++i)
+	{
+		if (Dest[i] == INDEX_NONE) continue;
+
+		const FPackedTile& NewTile = Grid->Tiles[Dest[i]];
+		if (NewTile.TileType == ETileType::Checkpoint)
+		{
+			ReachCheckpoint(i, NewTile.CheckpointNumber);
+		}
+		else if (NewTile.TileType == ETileType::Pit)
+		{
+			Emit(ERallyEventType::PitFall, i, Robots[i].X, Robots[i].Y, 0, Robots[i].MaxHealth);
+			ApplyDamage(i, Robots[i].MaxHealth);
+		}
+	}
+}
+
+void FRallySimulator::ApplyDamage(int32 RobotIndex, int32 Amount)
+{
+	FRallyRobotState& Robot = Robots[RobotIndex];
+	if (!Robot.bAlive) return;
+
+	Robot.Health = FMath::Max(0, Robot.Health - Amount);
+	if (Robot.Health > 0) return;
+
+	Robot.Lives--;
+	Emit(ERallyEventType::Destroyed, RobotIndex, Robot.X, Robot.Y, 0, Robot.Lives);
+
+	if (Robot.Lives > 0)
+	{
+		Robot.Health = Robot.MaxHealth;
+		Robot.X = Robot.RespawnX;
+		Robot.Y = Robot.RespawnY;
+		Emit(ERallyEventType::Respawn, RobotIndex, Robot.X, Robot.Y, 0, Robot.Lives);
+	}
+	else
+	{
+		Robot.bAlive = false;
+	}
+}
+
+void FRallySimulator::ReachCheckpoint(int32 RobotIndex, int32 Number)
+{
+	FRallyRobotState& Robot = Robots[RobotIndex];
+
+	ERallyCheckpointResult Result;
+	if (Number == Robot.Checkpoint + 1)
+	{
+		Robot.Checkpoint = Number;
+		Robot.RespawnX = Robot.X;
+		Robot.RespawnY = Robot.Y;
+		Result = ERallyCheckpointResult::Reached;
+	}
+	else if (Number > Robot.Checkpoint + 1)
+	{
+		Result = ERallyCheckpointResult::OutOfOrder;
+	}
+	else
+	{
+		Result = ERallyCheckpointResult::AlreadyVisited;
+	}
+
+	Emit(ERallyEventType::Checkpoint, RobotIndex, Robot.X, Robot.Y, Number, static_cast<int32>(Result));
+}
+
+void FRallySimulator::CheckWinLose()
+{
+	int32 AliveRobots = 0;
+
+	for (int32 i = 0; i < Robots.Num(); ++i)
+	{
+		if (!Robots[i].bAlive) continue;
+		AliveRobots++;
+
+		// First robot to collect all checkpoints wins
+		if (TotalCheckpoints > 0 && Robots[i].Checkpoint >= TotalCheckpoints)
+		{
+			bGameOver = true;
+			Winner = i;
+			Emit(ERallyEventType::Victory, i, 0, 0, 0, TotalCheckpoints);
+			return;
+		}
+	}
+
+	if (AliveRobots == 0)
+	{
+		bGameOver = true;
+		Emit(ERallyEventType::AllDestroyed, 0);
+	}
+}
+
+void FRallySimulator::Emit(ERallyEventType Type, int32 RobotIndex, int32 X, int32 Y, int32 Param, int32 Value)
+{
+	if (!Events) return;
+
+	FRallyEvent& Event = Events->AddDefaulted_GetRef();
+	Event.Type = Type;
+	Event.Robot = static_cast<uint8>(RobotIndex);
+	Event.Register = static_cast<uint8>(CurrentRegister);
+	Event.X = static_cast<int16>(X);
+	Event.Y = static_cast<int16>(Y);
+	Event.Param = static_cast<int16>(Param);
+	Event.Value = static_cast<int16>(Value);
+}
@@ -0,0 +1,164 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridManager.h"
+
+// Forward declare ECardAction (defined in RobotRallyGameMode.h)
+enum class ECardAction : uint8;
+
+// Robot state as seen by the rules (no actors, no timers)
+struct FRallyRobotState
+{
+	int32 X = 0;
+	int32 Y = 0;
+	uint8 Facing = 0;  // EGridDirection value (0=North, 1=East, 2=South, 3=West)
+	int32 Health = 10;
+	int32 MaxHealth = 10;
+	int32 Lives = 3;
+	int32 Checkpoint = 0;
+	int32 RespawnX = 0;
+	int32 RespawnY = 0;
+	bool bAlive = true;
+
+	bool operator==(const FRallyRobotState& Other) const
+	{
+		return X == Other.X && Y == Other.Y && Facing == Other.Facing
+			&& Health == Other.Health && MaxHealth == Other.MaxHealth && Lives == Other.Lives
+			&& Checkpoint == Other.Checkpoint && RespawnX == Other.RespawnX && RespawnY == Other.RespawnY
+			&& bAlive == Other.bAlive;
+	}
+	bool operator!=(const FRallyRobotState& Other) const { return !(*this == Other); }
+};
+
+struct FRallyCard
+{
+	ECardAction Action = static_cast<ECardAction>(0);
+	int32 Priority = 0;
+};
+
+struct FRallyProgram
+{
+	TArray<FRallyCard, TInlineAllocator<5>> Cards;
+};
+
+enum class ERallyEventType : uint8
+{
+	CardStart,        // Param = ECardAction, Value = priority
+	Move,             // X/Y = new tile, Param = 1 if pushed by another robot
+	Rotate,           // Param = rotation steps, Value = new facing
+	BoardElements,    // All cards of the register resolved, board elements activate
+	PitFall,          // Value = damage
+	LaserHit,         // Value = damage
+	Destroyed,        // Value = lives remaining
+	Respawn,          // X/Y = respawn tile
+	Checkpoint,       // Param = checkpoint number, Value = ERallyCheckpointResult
+	ConveyorMove,     // X/Y = new tile
+	ConveyorBlocked,  // Conveyor move cancelled, Param = 0 wall, 1 another robot
+	RegisterEnd,
+	Victory,          // Value = total checkpoints
+	AllDestroyed
+};
+
+enum class ERallyCheckpointResult : uint8
+{
+	Reached,
+	OutOfOrder,
+	AlreadyVisited
+};
+
+// One step of a resolved round (12 bytes, replayed by the GameMode as animation)
+struct FRallyEvent
+{
+	ERallyEventType Type = ERallyEventType::RegisterEnd;
+	uint8 Robot = 0;
+	uint8 Register = 0;
+	int16 X = 0;
+	int16 Y = 0;
+	int16 Param = 0;
+	int16 Value = 0;
+};
+
+/**
+ * Headless, deterministic Robot Rally rules.
+ * Resolves cards, pushes, tile effects, conveyors and win/lose checks on plain
+ * robot states in one call. Optionally records the outcome as an event list.
+ * Robot indices match ARobotRallyGameMode::Robots.
+ */
+class ROBOTRALLY_API FRallySimulator
+{
+public:
+	static constexpr int32 NUM_REGISTERS = 5;
+
+	// The grid must outlive the simulator
+	FRallySimulator(const FTileGrid& InGrid, int32 InTotalCheckpoints);
+
+	// Copy of Other's robots and programs, reading from a different (e.g. copied) grid
+	FRallySimulator(const FRallySimulator& Other, const FTileGrid& InGrid);
+
+	int32 AddRobot(const FRallyRobotState& State);
+	void SetProgram(int32 RobotIndex, const FRallyProgram& Program);
+
+	// Overwrite a robot's state (e.g. to resync with a recorded keyframe)
+	void SetRobot(int32 RobotIndex, const FRallyRobotState& State);
+
+	int32 NumRobots() const { return Robots.Num(); }
+	const FRallyRobotState& GetRobot(int32 RobotIndex) const { return Robots[RobotIndex]; }
+	const FRallyProgram& GetProgram(int32 RobotIndex) const { return Programs[RobotIndex]; }
+
+	bool IsGameOver() const { return bGameOver; }
+
+	const FTileGrid& GetGrid() const { return *Grid; }
+	int32 GetTotalCheckpoints() const { return TotalCheckpoints; }
+
+	// Index of the winning robot, or INDEX_NONE
+	int32 GetWinner() const { return Winner; }
+
+	// Resolve all registers (stops early on game over)
+	void ResolveRound(TArray<FRallyEvent>* OutEvents = nullptr);
+
+	// Resolve one register: cards in priority order, then board elements
+	void ResolveRegister(int32 Register, TArray<FRallyEvent>* OutEvents = nullptr);
+
+	// Execute a single card for one robot
+	void ExecuteCard(int32 RobotIndex, const FRallyCard& Card, TArray<FRallyEvent>* OutEvents = nullptr);
+
+	// Tile effects, conveyors and win/lose check
+	void ResolveBoardElements(TArray<FRallyEvent>* OutEvents = nullptr);
+
+	static void GetDirectionDelta(uint8 Facing, int32& OutDX, int32& OutDY);
+
+private:
+	void ResolveRegisterInternal(int32 Register);
+	void ExecuteCardInternal(int32 RobotIndex, const FRallyCard& Card);
+	void ResolveBoardElementsInternal();
+
+	void MoveRobot(int32 RobotIndex, int32 Distance);
+	void RotateRobot(int32 RobotIndex, int32 Steps);
+	bool TryPushRobot(int32 RobotIndex, int32 DX, int32 DY);
+	int32 FindRobotAt(int32 X, int32 Y, int32 IgnoreIndex) const;
+
+	void ApplyDamage(int32 RobotIndex, int32 Amount);
+	void ReachCheckpoint(int32 RobotIndex, int32 Number);
+	void ResolveConveyors();
+	void CheckWinLose();
+
+	// Robots can walk onto any in-bounds tile, pits included
+	bool IsValidTile(int32 X, int32 Y) const;
+
+	void Emit(ERallyEventType Type, int32 RobotIndex, int32 X = 0, int32 Y = 0, int32 Param = 0, int32 Value = 0);
+
+	const FTileGrid* Grid;
+	int32 TotalCheckpoints = 0;
+
+	TArray<FRallyRobotState, TInlineAllocator<8>> Robots;
+	TArray<FRallyProgram, TInlineAllocator<8>> Programs;
+
+	bool bGameOver = false;
+	int32 Winner = INDEX_NONE;
+
+	// Event sink for the call in progress (nullptr = don't record)
+	TArray<FRallyEvent>* Events = nullptr;
+	int32 CurrentRegister = 0;
+};
@@ -4,7 +4,10 @@
 #include "RobotPawn.h"
 #include "RobotMovementComponent.h"
 #include "GridManager.h"
+#include "RallyPlanner.h"
 #include "Engine/World.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
 
 ARobotAIController::ARobotAIController()
 {
@@ -21,6 +24,13 @@ void ARobotAIController::OnPossess(APawn* InPawn)
 		(int32)DifficultyLevel);
 }
 
+void ARobotAIController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Drop any planning result still in flight
+	++PlanningSerial;
+	Super::EndPlay(EndPlayReason);
+}
+
 void ARobotAIController::StartCardSelection()
 {
 	if (!ControlledRobot || !GameMode) return;
@@ -28,13 +38,19 @@ void ARobotAIController::StartCardSelection()
 
 	UE_LOG(LogTemp, Log, TEXT("AI StartCardSelection - Difficulty: %d"), (int32)DifficultyLevel);
 
+	++PlanningSerial;
+
 	switch (DifficultyLevel)
 	{
 	case ERobotControllerType::AI_Easy:
 		SelectCardsEasy();
 		break;
 	case ERobotControllerType::AI_Medium:
+		SelectCardsMedium();
+		break;
 	case ERobotControllerType::AI_Hard:
+		// Ready is signalled once the background search finishes
+		if (StartHardPlanning()) return;
 		SelectCardsMedium();
 		break;
 	default:
@@ -70,7 +86,7 @@ void ARobotAIController::SelectCardsEasy()
 	// Shuffle and pick first 5
 	for (int32 i = Available.Num() - 1; i > 0; --i)
 	{
-		int32 j = FMath::RandRange(0, i);
+		int32 j = RandomStream.RandRange(0, i);
 		Available.Swap(i, j);
 	}
 
@@ -153,6 +169,75 @@ void ARobotAIController::SelectCardsMedium()
 		UsedIndices.Num(), TargetPos.X, TargetPos.Y);
 }
 
+bool ARobotAIController::StartHardPlanning()
+{
+	// Hard AI: search ordered selections from the hand through the rules simulator
+	const FRobotProgram* Program = GameMode->RobotPrograms.FindByPredicate([this](const FRobotProgram& P)
+	{
+		return P.Robot == ControlledRobot;
+	});
+
+	const int32 RobotIndex = GameMode->Robots.IndexOfByKey(ControlledRobot);
+	if (!Program || Program->HandCards.Num() < ARobotRallyGameMode::NUM_REGISTERS ||
+		!GameMode->GridManagerInstance || RobotIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Everything the task touches is copied or immutable
+	TArray<FRallyCard, TInlineAllocator<16>> Hand;
+	for (const FRobotCard& Card : Program->HandCards)
+	{
+		Hand.Add({ Card.Action, Card.Priority });
+	}
+
+	TSharedRef<const FRallyPlanningSnapshot> Snapshot = GameMode->GetPlanningSnapshot();
+	TWeakObjectPtr<ARobotAIController> WeakThis(this);
+	const int32 Serial = PlanningSerial;
+	const double Budget = HardPlanningBudgetSeconds;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [Snapshot, Hand = MoveTemp(Hand), RobotIndex, Budget, WeakThis, Serial]()
+	{
+		FRallyPlanner Planner(Snapshot->Sim, RobotIndex);
+		FRallyPlanResult Result = Planner.Plan(Hand, Budget);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, Result = MoveTemp(Result)]()
+		{
+			if (ARobotAIController* Controller = WeakThis.Get())
+			{
+				Controller->ApplyPlannedProgram(Serial, Result);
+			}
+		});
+	});
+
+	return true;
+}
+
+void ARobotAIController::ApplyPlannedProgram(int32 Serial, const FRallyPlanResult& Result)
+{
+	// Stale: a newer selection started, or the phase moved on while planning
+	if (Serial != PlanningSerial) return;
+	if (!ControlledRobot || !GameMode || GameMode->CurrentState != EGameState::Programming) return;
+
+	if (Result.HandIndices.Num() < ARobotRallyGameMode::NUM_REGISTERS)
+	{
+		SelectCardsMedium();
+	}
+	else
+	{
+		for (int32 HandIndex : Result.HandIndices)
+		{
+			GameMode->SelectCardFromHand(ControlledRobot, HandIndex);
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("AI Hard: Selected %d cards (score %.1f, %d nodes, %d memo hits%s)"),
+			Result.HandIndices.Num(), Result.Score, Result.NodesVisited, Result.MemoHits,
+			Result.bCompleted ? TEXT("") : TEXT(", budget exhausted"));
+	}
+
+	GameMode->OnControllerReady(this);
+}
+
 float ARobotAIController::ScoreCard(ECardAction Action, FIntVector CurrentPos, EGridDirection CurrentFacing,
 	FIntVector TargetPos, AGridManager* Grid) const
 {
@@ -248,14 +333,11 @@ FIntVector ARobotAIController::FindNextCheckpointPosition() const
 	int32 NextCheckpoint = ControlledRobot->CurrentCheckpoint + 1;
 	AGridManager* Grid = GameMode->GridManagerInstance;
 
-	// Search grid for the next checkpoint
-	for (auto& Pair : Grid->GridMap)
+	// Look up the next checkpoint
+	FIntVector CheckpointCoords;
+	if (Grid->GetCheckpointPosition(NextCheckpoint, CheckpointCoords))
 	{
-		if (Pair.Value.TileType == ETileType::Checkpoint &&
-			Pair.Value.CheckpointNumber == NextCheckpoint)
-		{
-			return Pair.Key;
-		}
+		return CheckpointCoords;
 	}
 
 	// No checkpoint found - head toward grid center as fallback
@@ -9,6 +9,7 @@
 
 class ARobotPawn;
 class AGridManager;
+struct FRallyPlanResult;
 
 UCLASS()
 class ROBOTRALLY_API ARobotAIController : public AAIController
@@ -18,21 +19,36 @@ class ROBOTRALLY_API ARobotAIController : public AAIController
 public:
 	ARobotAIController();
 
-	// Called by GameMode at the start of each programming phase
+	// Called by GameMode at the start of each programming phase.
+	// AI_Hard plans on a worker thread and signals OnControllerReady when the result is applied.
 	void StartCardSelection();
 
+	// Seed this controller's random stream (set by GameMode from the match seed)
+	void InitRandomStream(int32 Seed) { RandomStream.Initialize(Seed); }
+
 	// Difficulty level set by GameMode after spawning
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AI")
 	ERobotControllerType DifficultyLevel = ERobotControllerType::AI_Easy;
 
+	// Wall-clock time AI_Hard may spend searching for a program each turn
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (ClampMin = "0.01"))
+	float HardPlanningBudgetSeconds = 0.2f;
+
 protected:
 	virtual void OnPossess(APawn* InPawn) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
 	// Card selection strategies per difficulty
 	void SelectCardsEasy();
 	void SelectCardsMedium();
 
+	// Launch the AI_Hard search as a background task; false if it could not be started
+	bool StartHardPlanning();
+
+	// Game thread: select the planned cards and report ready
+	void ApplyPlannedProgram(int32 Serial, const FRallyPlanResult& Result);
+
 	// Evaluate a card's score: how much it helps reach the target
 	// Higher score = better card. Simulates the card action and measures distance improvement.
 	float ScoreCard(ECardAction Action, FIntVector CurrentPos, EGridDirection CurrentFacing,
@@ -57,4 +73,10 @@ private:
 
 	UPROPERTY()
 	ARobotRallyGameMode* GameMode;
+
+	// Owned per controller so matches replay and concurrent simulations share no RNG state
+	FRandomStream RandomStream;
+
+	// Bumped per selection; results from older planning tasks are dropped
+	int32 PlanningSerial = 0;
 };
@@ -3,6 +3,9 @@
 #include "RobotController.h"
 #include "RobotPawn.h"
 #include "RobotRallyGameMode.h"
+#include "RobotRallyGameState.h"
+#include "RobotRallyPlayerState.h"
+#include "RobotRallyHUD.h"
 #include "RobotMovementComponent.h"
 #include "Engine/World.h"
 
@@ -22,6 +25,20 @@ void ARobotController::BeginPlay()
 
 	UE_LOG(LogTemp, Log, TEXT("RobotController::BeginPlay - GameMode: %s, NetMode: %d"),
 		GameMode ? TEXT("Valid") : TEXT("NULL"), (int32)GetNetMode());
+
+	// The board hash may have replicated before this controller existed
+	if (IsLocalController() && !HasAuthority())
+	{
+		if (ARobotRallyGameState* GS = GetWorld()->GetGameState<ARobotRallyGameState>())
+		{
+			GS->RequestBoardIfNeeded();
+		}
+	}
+}
+
+void ARobotController::RequestBoard(int32 Offset)
+{
+	ServerRequestBoard(Offset);
 }
 
 void ARobotController::OnPossess(APawn* InPawn)
@@ -88,7 +105,7 @@ void ARobotController::OnMoveForward()
 		if (!bCurrentlyMoving)
 		{
 			ControlledRobot->RobotMovement->MoveInGrid(1);
-			GameMode->StartManualMoveTick();
+			GameMode->WaitForManualMove();
 		}
 	}
 }
@@ -108,7 +125,7 @@ void ARobotController::OnMoveBackward()
 		if (!bCurrentlyMoving)
 		{
 			ControlledRobot->RobotMovement->MoveInGrid(-1);
-			GameMode->StartManualMoveTick();
+			GameMode->WaitForManualMove();
 		}
 	}
 }
@@ -184,8 +201,22 @@ void ARobotController::SelectCard(int32 CardIndex)
 	}
 	else
 	{
-		// Network: send RPC to server
-		ServerSelectCard(CardIndex);
+		// Network: fill registers locally; the program is sent in one RPC
+		ARobotRallyPlayerState* PS = GetPlayerState<ARobotRallyPlayerState>();
+		if (!PS || !CanEditLocalProgram()) return;
+
+		const int32 Register = PS->SelectLocalCard(CardIndex);
+		if (Register == INDEX_NONE) return;
+
+		const FRobotCard& Card = PS->Rep_HandCards[CardIndex];
+		ShowLocalGameEvent(ERallyGameEventType::CardSelected, Register,
+			static_cast<int32>(Card.Action), Card.Priority);
+
+		// Submit as soon as all registers are filled (same as standalone auto-ready)
+		if (!PS->GetDisplayedRegisterSlots().Contains(-1))
+		{
+			SubmitLocalProgram();
+		}
 	}
 }
 
@@ -211,7 +242,10 @@ void ARobotController::OnExecuteProgram()
 	}
 	else
 	{
-		ServerCommitProgram();
+		if (CanEditLocalProgram())
+		{
+			SubmitLocalProgram();
+		}
 	}
 }
 
@@ -227,106 +261,132 @@ void ARobotController::OnUndoSelection()
 	}
 	else
 	{
-		ServerUndoSelection();
+		ARobotRallyPlayerState* PS = GetPlayerState<ARobotRallyPlayerState>();
+		if (!PS || !CanEditLocalProgram()) return;
+
+		const int32 Register = PS->UndoLocalCard();
+		if (Register != INDEX_NONE)
+		{
+			ShowLocalGameEvent(ERallyGameEventType::RegisterCleared, Register);
+		}
 	}
 }
 
-// --- Server RPC implementations ---
+// --- Network: client-local selection ---
 
-bool ARobotController::ServerSelectCard_Validate(int32 HandIndex)
+bool ARobotController::CanEditLocalProgram() const
 {
-	return HandIndex >= 0 && HandIndex < 20; // Reasonable upper bound
+	const ARobotRallyGameState* GS = GetWorld()->GetGameState<ARobotRallyGameState>();
+	return GS && GS->Rep_CurrentGameState == EGameState::Programming;
 }
 
-void ARobotController::ServerSelectCard_Implementation(int32 HandIndex)
+void ARobotController::ShowLocalGameEvent(ERallyGameEventType Type, int32 A, int32 B, int32 C)
 {
-	if (!GameMode) GameMode = Cast<ARobotRallyGameMode>(GetWorld()->GetAuthGameMode());
-	if (!GameMode) return;
+	ARobotRallyHUD* HUD = Cast<ARobotRallyHUD>(GetHUD());
+	if (!HUD) return;
+
+	const ARobotRallyGameState* GS = GetWorld()->GetGameState<ARobotRallyGameState>();
+	const ARobotRallyPlayerState* PS = GetPlayerState<ARobotRallyPlayerState>();
+
+	FRallyGameEvent Event;
+	Event.Type = Type;
+	Event.Robot = static_cast<uint8>(GS && PS ? FMath::Max(0, GS->AllRobots.Find(PS->Rep_Robot)) : 0);
+	Event.A = static_cast<int16>(A);
+	Event.B = static_cast<int16>(B);
+	Event.C = static_cast<int16>(C);
+
+	FColor Color;
+	const FString Text = Event.ToText(Color);
+	HUD->AddEventMessage(Text, Color);
+}
 
-	ARobotPawn* Robot = Cast<ARobotPawn>(GetPawn());
-	if (!Robot) return;
+void ARobotController::SubmitLocalProgram()
+{
+	ARobotRallyPlayerState* PS = GetPlayerState<ARobotRallyPlayerState>();
+	if (!PS) return;
 
-	if (GameMode->CurrentState != EGameState::Programming)
-	{
-		ClientNotifyError(TEXT("Not in programming phase!"));
-		return;
-	}
+	ServerSubmitProgram(PS->GetDisplayedRegisterSlots());
+}
 
-	GameMode->SelectCardFromHand(Robot, HandIndex);
+// --- Server RPC implementations ---
 
-	// Check if all registers filled - auto-ready
-	FRobotProgram* Program = GameMode->RobotPrograms.FindByPredicate([Robot](const FRobotProgram& P)
-	{
-		return P.Robot == Robot;
-	});
+bool ARobotController::ServerSubmitProgram_Validate(const TArray<int32>& HandIndices)
+{
+	if (HandIndices.Num() != ARobotRallyGameMode::NUM_REGISTERS) return false;
 
-	if (Program)
+	for (int32 HandIndex : HandIndices)
 	{
-		int32 FilledCount = 0;
-		for (int32 Slot : Program->RegisterSlots)
-		{
-			if (Slot != -1) FilledCount++;
-		}
-
-		if (FilledCount == ARobotRallyGameMode::NUM_REGISTERS)
-		{
-			GameMode->OnControllerReady(this);
-		}
+		if (HandIndex < -1 || HandIndex >= 20) return false; // Reasonable upper bound
 	}
-}
-
-bool ARobotController::ServerUndoSelection_Validate()
-{
 	return true;
 }
 
-void ARobotController::ServerUndoSelection_Implementation()
+void ARobotController::ServerSubmitProgram_Implementation(const TArray<int32>& HandIndices)
 {
 	if (!GameMode) GameMode = Cast<ARobotRallyGameMode>(GetWorld()->GetAuthGameMode());
 	if (!GameMode) return;
 
-	if (GameMode->CurrentState != EGameState::Programming) return;
-
-	// Undo for this player's robot specifically
 	ARobotPawn* Robot = Cast<ARobotPawn>(GetPawn());
 	if (!Robot) return;
 
-	FRobotProgram* Program = GameMode->RobotPrograms.FindByPredicate([Robot](const FRobotProgram& P)
+	FString Error;
+	if (!GameMode->SubmitProgram(Robot, HandIndices, Error))
 	{
-		return P.Robot == Robot;
-	});
+		ClientNotifyError(Error);
+		return;
+	}
 
-	if (!Program) return;
+	GameMode->OnControllerReady(this);
+}
 
-	// Find the last filled register and clear it
-	for (int32 i = ARobotRallyGameMode::NUM_REGISTERS - 1; i >= 0; --i)
-	{
-		if (Program->RegisterSlots[i] != -1)
-		{
-			GameMode->ShowEventMessage(FString::Printf(TEXT("Cleared R%d"), i + 1), FColor::Yellow);
-			Program->RegisterSlots[i] = -1;
-			GameMode->SyncPlayerStateHand(Robot);
-			return;
-		}
-	}
+void ARobotController::ClientNotifyError_Implementation(const FString& Message)
+{
+	UE_LOG(LogTemp, Warning, TEXT("Server error: %s"), *Message);
 }
 
-bool ARobotController::ServerCommitProgram_Validate()
+bool ARobotController::ServerRequestBoard_Validate(int32 Offset)
 {
-	return true;
+	return Offset >= 0;
 }
 
-void ARobotController::ServerCommitProgram_Implementation()
+void ARobotController::ServerRequestBoard_Implementation(int32 Offset)
 {
-	if (!GameMode) GameMode = Cast<ARobotRallyGameMode>(GetWorld()->GetAuthGameMode());
-	if (!GameMode) return;
+	ARobotRallyGameState* GS = GetWorld()->GetGameState<ARobotRallyGameState>();
+	if (!GS || GS->GetBoardBlob().Num() == 0) return;
 
-	if (GameMode->CurrentState != EGameState::Programming) return;
+	// Throttled per connection: a new transfer at most once per interval, and only the
+	// chunk following the last one sent, so a client never has more than one in flight
+	if (Offset == 0)
+	{
+		const double Now = GetWorld()->GetRealTimeSeconds();
+		if (Now - LastBoardRequestTime < BOARD_REQUEST_INTERVAL)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: board requested again too soon, ignored"), *GetName());
+			return;
+		}
+		LastBoardRequestTime = Now;
+	}
+	else if (Offset != BoardSendOffset)
+	{
+		return;
+	}
 
-	GameMode->OnControllerReady(this);
+	const TArray<uint8>& Blob = GS->GetBoardBlob();
+	if (Offset >= Blob.Num())
+	{
+		BoardSendOffset = INDEX_NONE;
+		return;
+	}
+
+	const int32 Size = FMath::Min(BOARD_CHUNK_SIZE, Blob.Num() - Offset);
+	BoardSendOffset = Offset + Size < Blob.Num() ? Offset + Size : INDEX_NONE;
+	ClientReceiveBoardChunk(GS->Rep_BoardHash, Offset, Blob.Num(), TArray<uint8>(Blob.GetData() + Offset, Size));
 }
 
-void ARobotController::ClientNotifyError_Implementation(const FString& Message)
+void ARobotController::ClientReceiveBoardChunk_Implementation(uint64 Hash, int32 Offset, int32 TotalSize, const TArray<uint8>& Chunk)
 {
-	UE_LOG(LogTemp, Warning, TEXT("Server error: %s"), *Message);
+	if (ARobotRallyGameState* GS = GetWorld()->GetGameState<ARobotRallyGameState>())
+	{
+		GS->ReceiveBoardChunk(Hash, Offset, TotalSize, Chunk);
+	}
 }
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "RallyGameEvent.h"
 #include "RobotController.generated.h"
 
 class ARobotPawn;
@@ -27,6 +28,16 @@ protected:
 	virtual void BeginPlay() override;
 	virtual void OnPossess(APawn* InPawn) override;
 
+public:
+	// Client: fetch the base board from the server (no local cached copy), one chunk at a time
+	void RequestBoard(int32 Offset);
+
+	// Board bytes per RPC, well under net.MaxRepArraySize
+	static constexpr int32 BOARD_CHUNK_SIZE = 1024;
+
+	// Server: minimum seconds between two board transfers to the same connection
+	static constexpr double BOARD_REQUEST_INTERVAL = 5.0;
+
 private:
 	// Movement input handlers
 	void OnMoveForward();
@@ -52,26 +63,42 @@ private:
 	// Helper to select card by index
 	void SelectCard(int32 CardIndex);
 
-	// --- Server RPCs ---
+	// Network: registers are edited locally during the programming phase
+	bool CanEditLocalProgram() const;
 
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerSelectCard(int32 HandIndex);
+	// Network: send the locally selected registers to the server
+	void SubmitLocalProgram();
 
+	// Network: event-log line for a local action, formatted like server events
+	void ShowLocalGameEvent(ERallyGameEventType Type, int32 A = 0, int32 B = 0, int32 C = 0);
+
+	// --- Server RPCs ---
+
+	// Whole program in one call: hand index per register (-1 = empty), validated atomically
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerUndoSelection();
+	void ServerSubmitProgram(const TArray<int32>& HandIndices);
 
+	// Offset 0 starts a transfer, later offsets continue it where the last chunk ended
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerCommitProgram();
+	void ServerRequestBoard(int32 Offset);
 
 	// --- Client RPCs ---
 
 	UFUNCTION(Client, Reliable)
 	void ClientNotifyError(const FString& Message);
 
+	// Blob bytes [Offset, Offset + Chunk.Num()) of the board with hash Hash, TotalSize bytes in all
+	UFUNCTION(Client, Reliable)
+	void ClientReceiveBoardChunk(uint64 Hash, int32 Offset, int32 TotalSize, const TArray<uint8>& Chunk);
+
 	// Cached references
 	UPROPERTY()
 	ARobotPawn* ControlledRobot;
 
 	UPROPERTY()
 	ARobotRallyGameMode* GameMode;
+
+	// Server: board transfer to this connection (next offset, INDEX_NONE when idle) and when it started
+	int32 BoardSendOffset = INDEX_NONE;
+	double LastBoardRequestTime = -BOARD_REQUEST_INTERVAL;
 };
@@ -3,9 +3,11 @@
 #include "RobotMovementComponent.h"
 #include "GridManager.h"
 #include "RobotPawn.h"
+#include "RobotRallyGameMode.h"
 #include "GameFramework/Actor.h"
 #include "Kismet/GameplayStatics.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "EngineUtils.h"
 
 URobotMovementComponent::URobotMovementComponent()
@@ -35,32 +37,119 @@ void URobotMovementComponent::BeginPlay()
 	}
 }
 
+bool FRobotGridState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// Header: facing (2 bits) | teleport (1 bit) | sequence (5 bits)
+	uint8 Header = (static_cast<uint8>(Facing) & 0x3)
+		| (bTeleport ? 0x4 : 0)
+		| static_cast<uint8>((Sequence & 0x1F) << 3);
+	Ar << Header;
+
+	// Coordinates: zigzag + packed ints, one byte each on boards up to 64 tiles wide
+	int16* Coords[] = { &X, &Y };
+	for (int16* Coord : Coords)
+	{
+		const int32 Value = *Coord;
+		uint32 Packed = (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+		Ar.SerializeIntPacked(Packed);
+		if (Ar.IsLoading())
+		{
+			*Coord = static_cast<int16>(static_cast<int32>(Packed >> 1) ^ -static_cast<int32>(Packed & 1));
+		}
+	}
+
+	if (Ar.IsLoading())
+	{
+		Facing = static_cast<EGridDirection>(Header & 0x3);
+		bTeleport = (Header & 0x4) != 0;
+		Sequence = Header >> 3;
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
 void URobotMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(URobotMovementComponent, Rep_TargetLocation);
-	DOREPLIFETIME(URobotMovementComponent, Rep_TargetRotation);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(URobotMovementComponent, Rep_GridState, Params);
 }
 
-void URobotMovementComponent::OnRep_TargetLocation()
+void URobotMovementComponent::OnRep_GridState()
 {
-	// Client receives new target from server - start interpolating
-	TargetLocation = Rep_TargetLocation;
-	bIsMoving = true;
+	// Server data may arrive before BeginPlay has resolved the GridManager
+	if (!GridManager)
+	{
+		GridManager = Cast<AGridManager>(
+			UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass())
+		);
+	}
+
+	const bool bPositionChanged = Rep_GridState.X != CurrentGridX || Rep_GridState.Y != CurrentGridY;
+	const bool bFacingChanged = Rep_GridState.Facing != FacingDirection;
+
+	CurrentGridX = Rep_GridState.X;
+	CurrentGridY = Rep_GridState.Y;
+	FacingDirection = Rep_GridState.Facing;
+
+	TargetLocation = GetTileLocation(CurrentGridX, CurrentGridY);
+	TargetRotation = GetOwner()->GetActorRotation();
+	TargetRotation.Yaw = GetFacingYaw(FacingDirection);
+
+	// Snap on teleport and on the first state received; otherwise interpolate like the server
+	if (Rep_GridState.bTeleport || !HasBegunPlay())
+	{
+		GetOwner()->SetActorLocationAndRotation(TargetLocation, TargetRotation);
+		bIsMoving = false;
+		bIsRotating = false;
+	}
+	else
+	{
+		bIsMoving |= bPositionChanged;
+		bIsRotating |= bFacingChanged;
+	}
+
+	if (bPositionChanged)
+	{
+		OnGridPositionChanged.Broadcast(CurrentGridX, CurrentGridY);
+	}
 }
 
-void URobotMovementComponent::OnRep_TargetRotation()
+void URobotMovementComponent::PublishGridState(bool bTeleport)
 {
-	// Client receives new rotation target from server - start interpolating
-	TargetRotation = Rep_TargetRotation;
-	bIsRotating = true;
+	if (!GetOwner()->HasAuthority()) return;
+
+	Rep_GridState.X = static_cast<int16>(CurrentGridX);
+	Rep_GridState.Y = static_cast<int16>(CurrentGridY);
+	Rep_GridState.Facing = FacingDirection;
+	Rep_GridState.bTeleport = bTeleport;
+	Rep_GridState.Sequence = (Rep_GridState.Sequence + 1) & 0x1F;
+	MARK_PROPERTY_DIRTY_FROM_NAME(URobotMovementComponent, Rep_GridState, this);
+}
+
+FVector URobotMovementComponent::GetTileLocation(int32 X, int32 Y) const
+{
+	FVector Location = GridManager
+		? GridManager->GridToWorld(FIntVector(X, Y, 0))
+		: FVector(X * GridSize, Y * GridSize, 0.0f);
+	Location.Z = GetOwner()->GetActorLocation().Z;
+	return Location;
+}
+
+float URobotMovementComponent::GetFacingYaw(EGridDirection Dir)
+{
+	return static_cast<float>(Dir) * 90.0f;
 }
 
 void URobotMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	const bool bWasActive = bIsMoving || bIsRotating;
+
 	// Smoothly interpolate to target location
 	if (bIsMoving)
 	{
@@ -88,6 +177,12 @@ void URobotMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType
 			bIsRotating = false;
 		}
 	}
+
+	// Notify listeners the moment the robot settles
+	if (bWasActive && !bIsMoving && !bIsRotating)
+	{
+		OnMovementFinished.Broadcast(this);
+	}
 }
 
 void URobotMovementComponent::GetDirectionDelta(EGridDirection Dir, int32& OutDX, int32& OutDY)
@@ -110,16 +205,17 @@ void URobotMovementComponent::InitializeGridPosition(int32 InGridX, int32 InGrid
 	// Sync target location/rotation with the grid position
 	if (GridManager)
 	{
-		TargetLocation = GridManager->GridToWorld(FIntVector(InGridX, InGridY, 0));
-		TargetLocation.Z = GetOwner()->GetActorLocation().Z;
+		TargetLocation = GetTileLocation(InGridX, InGridY);
 	}
 	else
 	{
 		TargetLocation = GetOwner()->GetActorLocation();
 	}
 	TargetRotation = GetOwner()->GetActorRotation();
-	Rep_TargetLocation = TargetLocation;
-	Rep_TargetRotation = TargetRotation;
+	TargetRotation.Yaw = GetFacingYaw(InFacing);
+	GetOwner()->SetActorLocationAndRotation(TargetLocation, TargetRotation);
+
+	PublishGridState(true);
 }
 
 ARobotPawn* URobotMovementComponent::FindRobotAtPosition(int32 X, int32 Y) const
@@ -129,7 +225,13 @@ ARobotPawn* URobotMovementComponent::FindRobotAtPosition(int32 X, int32 Y) const
 
 	ARobotPawn* OwnerRobot = Cast<ARobotPawn>(GetOwner());
 
-	// Search all robot pawns in the world
+	// Server: O(1) lookup in the GameMode's occupancy index
+	if (ARobotRallyGameMode* GM = Cast<ARobotRallyGameMode>(World->GetAuthGameMode()))
+	{
+		return GM->FindRobotAt(X, Y, OwnerRobot);
+	}
+
+	// No GameMode (clients, editor tools): search all robot pawns in the world
 	for (TActorIterator<ARobotPawn> It(World); It; ++It)
 	{
 		ARobotPawn* Robot = *It;
@@ -280,11 +382,9 @@ void URobotMovementComponent::MoveInGrid(int32 Distance)
 	if (ValidSteps > 0)
 	{
 		bIsMoving = true;
+		PublishGridState(false);
 	}
 
-	// Sync replicated target for clients
-	Rep_TargetLocation = TargetLocation;
-
 	// Notify listeners of new grid position
 	OnGridPositionChanged.Broadcast(CurrentGridX, CurrentGridY);
 }
@@ -294,16 +394,38 @@ void URobotMovementComponent::MoveToWorldPosition(FVector NewTarget)
 	TargetLocation = NewTarget;
 	TargetLocation.Z = GetOwner()->GetActorLocation().Z;
 	bIsMoving = true;
-	Rep_TargetLocation = TargetLocation;
 }
 
 void URobotMovementComponent::SetGridPosition(int32 NewX, int32 NewY)
 {
 	CurrentGridX = NewX;
 	CurrentGridY = NewY;
+	PublishGridState(false);
 	OnGridPositionChanged.Broadcast(CurrentGridX, CurrentGridY);
 }
 
+void URobotMovementComponent::TeleportToGridPosition(int32 NewX, int32 NewY)
+{
+	TargetLocation = GetTileLocation(NewX, NewY);
+	GetOwner()->SetActorLocation(TargetLocation);
+	bIsMoving = false;
+
+	CurrentGridX = NewX;
+	CurrentGridY = NewY;
+	PublishGridState(true);
+	OnGridPositionChanged.Broadcast(CurrentGridX, CurrentGridY);
+}
+
+void URobotMovementComponent::SnapToFacing(EGridDirection NewFacing)
+{
+	FacingDirection = NewFacing;
+	TargetRotation = GetOwner()->GetActorRotation();
+	TargetRotation.Yaw = GetFacingYaw(NewFacing);
+	GetOwner()->SetActorRotation(TargetRotation);
+	bIsRotating = false;
+	PublishGridState(true);
+}
+
 void URobotMovementComponent::RotateInGrid(int32 Steps)
 {
 	if (bIsRotating)
@@ -321,5 +443,5 @@ void URobotMovementComponent::RotateInGrid(int32 Steps)
 	TargetRotation.Yaw += Steps * 90.0f;
 	TargetRotation.Yaw = FMath::RoundToFloat(TargetRotation.Yaw / 90.0f) * 90.0f;
 	bIsRotating = true;
-	Rep_TargetRotation = TargetRotation;
+	PublishGridState(false);
 }
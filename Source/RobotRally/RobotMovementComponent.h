@@ -18,7 +18,48 @@ enum class EGridDirection : uint8
 	West	// -Y
 };
 
+/**
+ * Replicated grid state of a robot. Clients derive the world transform from it
+ * through the GridManager. Sent as a one-byte header plus two packed coordinates.
+ */
+USTRUCT()
+struct ROBOTRALLY_API FRobotGridState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int16 X = 0;
+
+	UPROPERTY()
+	int16 Y = 0;
+
+	UPROPERTY()
+	EGridDirection Facing = EGridDirection::North;
+
+	// Bumped on every server update (5 bits on the wire) so repeated states still replicate
+	UPROPERTY()
+	uint8 Sequence = 0;
+
+	// Snap instead of interpolating (spawn, respawn)
+	UPROPERTY()
+	bool bTeleport = false;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FRobotGridState> : public TStructOpsTypeTraitsBase2<FRobotGridState>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+class URobotMovementComponent;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGridPositionChanged, int32, NewGridX, int32, NewGridY);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMovementFinished, URobotMovementComponent*, MovementComponent);
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class ROBOTRALLY_API URobotMovementComponent : public UActorComponent
@@ -75,6 +116,10 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "GridMovement")
 	FOnGridPositionChanged OnGridPositionChanged;
 
+	// Broadcast once the robot has settled (no movement or rotation left to interpolate)
+	UPROPERTY(BlueprintAssignable, Category = "GridMovement")
+	FOnMovementFinished OnMovementFinished;
+
 	// Move directly to a world position (for conveyor/external movement)
 	UFUNCTION(BlueprintCallable, Category = "GridMovement")
 	void MoveToWorldPosition(FVector NewTarget);
@@ -82,6 +127,15 @@ public:
 	// Force-set grid position without movement (used after conveyor updates)
 	void SetGridPosition(int32 NewX, int32 NewY);
 
+	// Place the owner on a tile immediately, without interpolation (respawn)
+	void TeleportToGridPosition(int32 NewX, int32 NewY);
+
+	// Turn the owner to a facing immediately, without interpolation (replay keyframes)
+	void SnapToFacing(EGridDirection NewFacing);
+
+	// World yaw for a grid facing
+	static float GetFacingYaw(EGridDirection Dir);
+
 	// Returns (DX, DY) delta for a given direction
 	static void GetDirectionDelta(EGridDirection Dir, int32& OutDX, int32& OutDY);
 
@@ -91,19 +145,19 @@ public:
 	// Try to push a robot in the given direction (returns true if successful)
 	bool TryPushRobot(class ARobotPawn* RobotToPush, int32 DX, int32 DY);
 
-	// Replicated targets for client interpolation
-	UPROPERTY(ReplicatedUsing = OnRep_TargetLocation)
-	FVector Rep_TargetLocation;
-
-	UPROPERTY(ReplicatedUsing = OnRep_TargetRotation)
-	FRotator Rep_TargetRotation;
-
 private:
-	UFUNCTION()
-	void OnRep_TargetLocation();
+	// Grid position and facing for clients; the only movement state that replicates
+	UPROPERTY(ReplicatedUsing = OnRep_GridState)
+	FRobotGridState Rep_GridState;
 
 	UFUNCTION()
-	void OnRep_TargetRotation();
+	void OnRep_GridState();
+
+	// Server: copy the current grid position and facing into Rep_GridState
+	void PublishGridState(bool bTeleport);
+
+	// World location of a tile at the owner's current height
+	FVector GetTileLocation(int32 X, int32 Y) const;
 
 	FVector TargetLocation;
 	FRotator TargetRotation;
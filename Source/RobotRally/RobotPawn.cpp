@@ -4,6 +4,7 @@
 #include "RobotMovementComponent.h"
 #include "RobotRallyGameMode.h"
 #include "GridManager.h"
+#include "RallyMaterialLibrary.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/StaticMesh.h"
@@ -11,17 +12,15 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/PlayerController.h"
 #include "Net/UnrealNetwork.h"
-
-#if WITH_EDITORONLY_DATA
-#include "Materials/Material.h"
-#include "Materials/MaterialExpressionVectorParameter.h"
-#endif
+#include "Net/Core/PushModel/PushModel.h"
 
 ARobotPawn::ARobotPawn()
 {
 	PrimaryActorTick.bCanEverTick = true;
 	bReplicates = true;
-	SetReplicateMovement(true);
+
+	// Transforms are derived from RobotMovement's replicated grid state
+	SetReplicateMovement(false);
 
 	// Initialize movement component
 	RobotMovement = CreateDefaultSubobject<URobotMovementComponent>(TEXT("RobotMovement"));
@@ -44,6 +43,9 @@ ARobotPawn::ARobotPawn()
 		CMC->DefaultLandMovementMode = MOVE_Flying;
 		CMC->SetMovementMode(MOVE_Flying);
 		CMC->bOrientRotationToMovement = false;
+
+		// Never drives the robot; ticking would only send client move RPCs
+		CMC->PrimaryComponentTick.bStartWithTickEnabled = false;
 	}
 
 	// Hide the default skeletal mesh (ACharacter has one)
@@ -94,51 +96,22 @@ void ARobotPawn::BeginPlay()
 	// Initialize lives and respawn point
 	Lives = MaxLives;
 	Health = MaxHealth;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, Lives, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, Health, this);
 	RespawnPosition = FIntVector(GridX, GridY, 0);
+	NotifyStatusChanged();
 
-	// Apply custom meshes if set, otherwise keep engine defaults
-	if (BodyMeshAsset)
-	{
-		BodyMesh->SetStaticMesh(BodyMeshAsset);
-	}
-	if (DirectionMeshAsset)
+	// Dedicated servers keep only the logical robot
+	if (IsNetMode(NM_DedicatedServer))
 	{
-		DirectionIndicator->SetStaticMesh(DirectionMeshAsset);
+		BodyMesh->DestroyComponent();
+		DirectionIndicator->DestroyComponent();
+		BodyMesh = nullptr;
+		DirectionIndicator = nullptr;
 	}
-
-	// Apply colored materials (created at runtime for proper Color parameter support)
-	UMaterialInterface* BaseMat = nullptr;
-
-#if WITH_EDITORONLY_DATA
-	UMaterial* Mat = NewObject<UMaterial>(GetTransientPackage(), NAME_None, RF_Transient);
-	Mat->MaterialDomain = MD_Surface;
-
-	UMaterialExpressionVectorParameter* ColorParam =
-		NewObject<UMaterialExpressionVectorParameter>(Mat);
-	ColorParam->ParameterName = TEXT("Color");
-	ColorParam->DefaultValue = FLinearColor::White;
-
-	UMaterialEditorOnlyData* EditorData = Mat->GetEditorOnlyData();
-	EditorData->ExpressionCollection.Expressions.Add(ColorParam);
-	EditorData->BaseColor.Expression = ColorParam;
-	EditorData->BaseColor.OutputIndex = 0;
-
-	Mat->PreEditChange(nullptr);
-	Mat->PostEditChange();
-	BaseMat = Mat;
-#endif
-
-	if (BaseMat)
+	else
 	{
-		// Apply body color from UPROPERTY
-		UMaterialInstanceDynamic* BodyMat = UMaterialInstanceDynamic::Create(BaseMat, this);
-		BodyMat->SetVectorParameterValue(TEXT("Color"), BodyColor);
-		BodyMesh->SetMaterial(0, BodyMat);
-
-		// Apply direction indicator color from UPROPERTY
-		UMaterialInstanceDynamic* ConeMat = UMaterialInstanceDynamic::Create(BaseMat, this);
-		ConeMat->SetVectorParameterValue(TEXT("Color"), DirectionColor);
-		DirectionIndicator->SetMaterial(0, ConeMat);
+		BuildVisuals();
 	}
 
 	if (RobotMovement)
@@ -146,6 +119,14 @@ void ARobotPawn::BeginPlay()
 		// Bind delegate for grid position sync
 		RobotMovement->OnGridPositionChanged.AddDynamic(this, &ARobotPawn::OnGridPositionUpdated);
 
+		// Clients take position and facing from the replicated grid state
+		if (!HasAuthority())
+		{
+			GridX = RobotMovement->GetCurrentGridX();
+			GridY = RobotMovement->GetCurrentGridY();
+			return;
+		}
+
 		// Determine initial facing direction from actor yaw
 		float NormYaw = FMath::Fmod(GetActorRotation().Yaw + 360.0f, 360.0f);
 		EGridDirection InitialFacing = EGridDirection::North;
@@ -162,6 +143,35 @@ void ARobotPawn::BeginPlay()
 	}
 }
 
+void ARobotPawn::BuildVisuals()
+{
+	// Apply custom meshes if set, otherwise keep engine defaults
+	if (BodyMeshAsset)
+	{
+		BodyMesh->SetStaticMesh(BodyMeshAsset);
+	}
+	if (DirectionMeshAsset)
+	{
+		DirectionIndicator->SetStaticMesh(DirectionMeshAsset);
+	}
+
+	// Tint the shared base material per robot
+	UMaterialInterface* BaseMat = FRallyMaterialLibrary::GetBaseMaterial();
+
+	if (BaseMat)
+	{
+		// Apply body color from UPROPERTY
+		UMaterialInstanceDynamic* BodyMat = UMaterialInstanceDynamic::Create(BaseMat, this);
+		BodyMat->SetVectorParameterValue(FRallyMaterialLibrary::ColorParameter, BodyColor);
+		BodyMesh->SetMaterial(0, BodyMat);
+
+		// Apply direction indicator color from UPROPERTY
+		UMaterialInstanceDynamic* ConeMat = UMaterialInstanceDynamic::Create(BaseMat, this);
+		ConeMat->SetVectorParameterValue(FRallyMaterialLibrary::ColorParameter, DirectionColor);
+		DirectionIndicator->SetMaterial(0, ConeMat);
+	}
+}
+
 void ARobotPawn::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
@@ -172,18 +182,32 @@ void ARobotPawn::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifeti
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(ARobotPawn, GridX);
-	DOREPLIFETIME(ARobotPawn, GridY);
-	DOREPLIFETIME(ARobotPawn, Health);
-	DOREPLIFETIME(ARobotPawn, bIsAlive);
-	DOREPLIFETIME(ARobotPawn, Lives);
-	DOREPLIFETIME(ARobotPawn, CurrentCheckpoint);
-	DOREPLIFETIME(ARobotPawn, BodyColor);
+	// Push model: only compared after being marked dirty where they change
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotPawn, Health, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotPawn, bIsAlive, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotPawn, Lives, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotPawn, CurrentCheckpoint, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotPawn, BodyColor, Params);
 }
 
 void ARobotPawn::OnRep_Health()
 {
 	UE_LOG(LogTemp, Log, TEXT("RobotPawn OnRep_Health: %d/%d"), Health, MaxHealth);
+	NotifyStatusChanged();
+}
+
+void ARobotPawn::OnRep_Status()
+{
+	NotifyStatusChanged();
+}
+
+void ARobotPawn::NotifyStatusChanged()
+{
+	++StatusVersion;
+	OnStatusChanged.Broadcast(this);
 }
 
 void ARobotPawn::ApplyDamage(int32 Amount)
@@ -194,7 +218,9 @@ void ARobotPawn::ApplyDamage(int32 Amount)
 	if (!HasAuthority()) return;
 
 	Health = FMath::Max(0, Health - Amount);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, Health, this);
 	UE_LOG(LogTemp, Log, TEXT("Robot took %d damage! Health: %d/%d"), Amount, Health, MaxHealth);
+	NotifyStatusChanged();
 
 	if (Health <= 0)
 	{
@@ -203,6 +229,7 @@ void ARobotPawn::ApplyDamage(int32 Amount)
 
 		// Attempt respawn
 		Lives--;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, Lives, this);
 		if (Lives > 0)
 		{
 			Respawn();
@@ -210,7 +237,9 @@ void ARobotPawn::ApplyDamage(int32 Amount)
 		else
 		{
 			bIsAlive = false;
+			MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, bIsAlive, this);
 			UE_LOG(LogTemp, Log, TEXT("Robot out of lives! Game Over."));
+			NotifyStatusChanged();
 		}
 	}
 }
@@ -223,27 +252,45 @@ void ARobotPawn::Respawn()
 	// Restore health
 	Health = MaxHealth;
 	bIsAlive = true;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, Health, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, bIsAlive, this);
+	NotifyStatusChanged();
 
 	// Teleport to respawn position
-	GridX = RespawnPosition.X;
-	GridY = RespawnPosition.Y;
-
 	if (RobotMovement && RobotMovement->GridManager)
 	{
-		FVector WorldPos = RobotMovement->GridManager->GridToWorld(RespawnPosition);
-		SetActorLocation(WorldPos);
-		RobotMovement->SetGridPosition(GridX, GridY);
+		// Updates GridX/GridY through OnGridPositionUpdated
+		RobotMovement->TeleportToGridPosition(RespawnPosition.X, RespawnPosition.Y);
 		UE_LOG(LogTemp, Log, TEXT("Robot respawned at (%d, %d) with %d lives remaining"), GridX, GridY, Lives);
 
 		// Notify game mode
 		ARobotRallyGameMode* GM = Cast<ARobotRallyGameMode>(GetWorld()->GetAuthGameMode());
 		if (GM)
 		{
-			GM->ShowEventMessage(
-				FString::Printf(TEXT("Robot respawned at (%d, %d). Lives: %d"), GridX, GridY, Lives),
-				FColor::Orange);
+			GM->PostGameEvent(ERallyGameEventType::Respawned, GM->Robots.Find(this), GridX, GridY, Lives);
 		}
 	}
+	else
+	{
+		GridX = RespawnPosition.X;
+		GridY = RespawnPosition.Y;
+	}
+}
+
+void ARobotPawn::SetStatus(int32 InHealth, int32 InLives, int32 InCheckpoint, const FIntVector& InRespawnPosition, bool bInAlive)
+{
+	if (!HasAuthority()) return;
+
+	Health = InHealth;
+	Lives = InLives;
+	CurrentCheckpoint = InCheckpoint;
+	RespawnPosition = InRespawnPosition;
+	bIsAlive = bInAlive;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, Health, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, Lives, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, CurrentCheckpoint, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, bIsAlive, this);
+	NotifyStatusChanged();
 }
 
 void ARobotPawn::ReachCheckpoint(int32 Number)
@@ -256,16 +303,16 @@ void ARobotPawn::ReachCheckpoint(int32 Number)
 	if (Number == CurrentCheckpoint + 1)
 	{
 		CurrentCheckpoint = Number;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, CurrentCheckpoint, this);
 		// Update respawn point to this checkpoint
 		RespawnPosition = FIntVector(GridX, GridY, 0);
+		NotifyStatusChanged();
 		UE_LOG(LogTemp, Log, TEXT("Checkpoint %d reached! Respawn point updated."), Number);
 		OnCheckpointReached.Broadcast(Number);
 
 		if (GM)
 		{
-			GM->ShowEventMessage(
-				FString::Printf(TEXT("Checkpoint %d reached! (Respawn point updated)"), Number),
-				FColor::Green);
+			GM->PostGameEvent(ERallyGameEventType::CheckpointReached, GM->Robots.Find(this), Number);
 		}
 	}
 	else if (Number > CurrentCheckpoint + 1)
@@ -274,9 +321,7 @@ void ARobotPawn::ReachCheckpoint(int32 Number)
 		UE_LOG(LogTemp, Warning, TEXT("Checkpoint %d reached out of order! Need checkpoint %d first."), Number, CurrentCheckpoint + 1);
 		if (GM)
 		{
-			GM->ShowEventMessage(
-				FString::Printf(TEXT("Wrong order! Need checkpoint %d first."), CurrentCheckpoint + 1),
-				FColor::Red);
+			GM->PostGameEvent(ERallyGameEventType::CheckpointOutOfOrder, GM->Robots.Find(this), CurrentCheckpoint + 1);
 		}
 	}
 	else
@@ -285,9 +330,7 @@ void ARobotPawn::ReachCheckpoint(int32 Number)
 		UE_LOG(LogTemp, Log, TEXT("Checkpoint %d already visited (current: %d)."), Number, CurrentCheckpoint);
 		if (GM)
 		{
-			GM->ShowEventMessage(
-				FString::Printf(TEXT("Checkpoint %d already visited."), Number),
-				FColor::Yellow);
+			GM->PostGameEvent(ERallyGameEventType::CheckpointRevisited, GM->Robots.Find(this), Number);
 		}
 	}
 }
@@ -310,6 +353,13 @@ void ARobotPawn::ExecuteRotateCommand(int32 Steps)
 
 void ARobotPawn::OnGridPositionUpdated(int32 NewGridX, int32 NewGridY)
 {
+	const FIntVector From(GridX, GridY, 0);
 	GridX = NewGridX;
 	GridY = NewGridY;
+
+	// Keep the server's occupancy index in sync
+	if (ARobotRallyGameMode* GM = Cast<ARobotRallyGameMode>(GetWorld()->GetAuthGameMode()))
+	{
+		GM->NotifyRobotMoved(this, From);
+	}
 }
@@ -12,6 +12,7 @@ class UStaticMeshComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnRobotDeath);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCheckpointReached, int32, CheckpointNumber);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnRobotStatusChanged, ARobotPawn* /*Robot*/);
 
 UCLASS()
 class ROBOTRALLY_API ARobotPawn : public ACharacter
@@ -55,11 +56,11 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Robot|Visual|Meshes")
 	FLinearColor DirectionColor = FLinearColor(0.9f, 0.8f, 0.1f);
 
-	// Grid coordinates
-	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite, Category = "Robot|Grid")
+	// Grid coordinates (mirrored from RobotMovement, which replicates them)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Robot|Grid")
 	int32 GridX;
 
-	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite, Category = "Robot|Grid")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Robot|Grid")
 	int32 GridY;
 
 	// Health system
@@ -72,7 +73,7 @@ public:
 	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadOnly, Category = "Robot|Health")
 	bool bIsAlive = true;
 
-	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadOnly, Category = "Robot|Health")
+	UPROPERTY(ReplicatedUsing = OnRep_Status, VisibleAnywhere, BlueprintReadOnly, Category = "Robot|Health")
 	int32 Lives = 3;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Robot|Health")
@@ -88,7 +89,7 @@ public:
 	FOnRobotDeath OnDeath;
 
 	// Checkpoint progress
-	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadOnly, Category = "Robot|Checkpoint")
+	UPROPERTY(ReplicatedUsing = OnRep_Status, VisibleAnywhere, BlueprintReadOnly, Category = "Robot|Checkpoint")
 	int32 CurrentCheckpoint = 0;
 
 	UFUNCTION(BlueprintCallable, Category = "Robot|Checkpoint")
@@ -97,6 +98,19 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Robot|Checkpoint")
 	FOnCheckpointReached OnCheckpointReached;
 
+	// Tile the robot returns to after being destroyed
+	FIntVector GetRespawnPosition() const { return RespawnPosition; }
+
+	// Server: overwrite health, lives, checkpoint progress, respawn tile and alive flag
+	// without damage, death or checkpoint events (replay keyframes)
+	void SetStatus(int32 InHealth, int32 InLives, int32 InCheckpoint, const FIntVector& InRespawnPosition, bool bInAlive);
+
+	// Health, lives or checkpoint changed (server: on write, client: on replication)
+	FOnRobotStatusChanged OnStatusChanged;
+
+	// Bumped on every status change so listeners can skip redundant updates
+	uint32 GetStatusVersion() const { return StatusVersion; }
+
 	// Executing a command from a card
 	UFUNCTION(BlueprintCallable, Category = "Robot|Actions")
 	void ExecuteMoveCommand(int32 Distance);
@@ -108,6 +122,16 @@ private:
 	UFUNCTION()
 	void OnRep_Health();
 
+	UFUNCTION()
+	void OnRep_Status();
+
+	void NotifyStatusChanged();
+
+	// Meshes and colored materials (skipped on dedicated servers)
+	void BuildVisuals();
+
+	uint32 StatusVersion = 0;
+
 	UFUNCTION()
 	void OnGridPositionUpdated(int32 NewGridX, int32 NewGridY);
 
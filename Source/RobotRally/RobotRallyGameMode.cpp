@@ -8,7 +8,9 @@
 #include "RobotController.h"
 #include "RobotAIController.h"
 #include "GridManager.h"
+#include "RallyPlanner.h"
 #include "RobotPawn.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "RobotMovementComponent.h"
 #include "Engine/World.h"
 #include "Engine/DirectionalLight.h"
@@ -17,6 +19,9 @@
 #include "Components/SkyLightComponent.h"
 #include "GameFramework/PlayerController.h"
 #include "Camera/CameraActor.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
 
 ARobotRallyGameMode::ARobotRallyGameMode()
 {
@@ -33,10 +38,57 @@ void ARobotRallyGameMode::ShowEventMessage(const FString& Text, FColor Color)
 	BroadcastEventMessage(Text, Color);
 }
 
+void ARobotRallyGameMode::PostGameEvent(ERallyGameEventType Type, int32 RobotIndex, int32 A, int32 B, int32 C)
+{
+	FRallyGameEvent Event;
+	Event.Type = Type;
+	Event.Robot = static_cast<uint8>(FMath::Max(0, RobotIndex));
+	Event.A = static_cast<int16>(A);
+	Event.B = static_cast<int16>(B);
+	Event.C = static_cast<int16>(C);
+
+	if (GetNetMode() == NM_Standalone)
+	{
+		FColor Color;
+		const FString Text = Event.ToText(Color);
+		BroadcastEventMessage(Text, Color);
+		return;
+	}
+
+	// Text is only built here when verbose logging is enabled
+	if (UE_LOG_ACTIVE(LogTemp, Verbose))
+	{
+		FColor Color;
+		UE_LOG(LogTemp, Verbose, TEXT("%s"), *Event.ToText(Color));
+	}
+
+	PendingGameEvents.Add(Event);
+
+	// Outside a round replay there is no register to batch with
+	if (RoundEvents.Num() == 0)
+	{
+		FlushGameEvents();
+	}
+}
+
+void ARobotRallyGameMode::FlushGameEvents()
+{
+	if (PendingGameEvents.Num() == 0) return;
+
+	if (ARobotRallyGameState* GS = GetGameState<ARobotRallyGameState>())
+	{
+		GS->MulticastGameEvents(PendingGameEvents);
+	}
+	PendingGameEvents.Reset();
+}
+
 void ARobotRallyGameMode::BroadcastEventMessage(const FString& Text, FColor Color)
 {
 	UE_LOG(LogTemp, Log, TEXT("%s"), *Text);
 
+	// Keep typed events ahead of this message
+	FlushGameEvents();
+
 	if (GetNetMode() == NM_Standalone)
 	{
 		// Standalone: directly add to local HUD
@@ -115,11 +167,15 @@ void ARobotRallyGameMode::AssignRobotToPlayer(APlayerController* NewPlayer)
 		{
 			NewPlayer->Possess(Robot);
 
+			// Owner changed; send it even if the robot is dormant for the programming phase
+			Robot->FlushNetDormancy();
+
 			// Set up PlayerState reference
 			ARobotRallyPlayerState* PS = Cast<ARobotRallyPlayerState>(NewPlayer->PlayerState);
 			if (PS)
 			{
 				PS->Rep_Robot = Robot;
+				MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyPlayerState, Rep_Robot, PS);
 			}
 
 			// Set up camera for this player
@@ -169,6 +225,9 @@ void ARobotRallyGameMode::SyncPlayerStateHand(ARobotPawn* Robot)
 	});
 	if (!Program) return;
 
+	Program->Version++;
+	OnProgramChanged.Broadcast(Robot);
+
 	// Find the PlayerController and PlayerState for this robot
 	AController* Controller = Robot->GetController();
 	APlayerController* PC = Cast<APlayerController>(Controller);
@@ -180,16 +239,52 @@ void ARobotRallyGameMode::SyncPlayerStateHand(ARobotPawn* Robot)
 	// Copy hand and registers to PlayerState for replication
 	PS->Rep_HandCards = Program->HandCards;
 	PS->Rep_RegisterSlots = Program->RegisterSlots;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyPlayerState, Rep_HandCards, PS);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyPlayerState, Rep_RegisterSlots, PS);
+
+	// Server state replaces any local selection of a listen-server host
+	PS->ResetLocalSelection();
+
+	// OnReps don't run on the server; notify a listen-server host's HUD directly
+	PS->NotifyCardsChanged();
+}
+
+void ARobotRallyGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+	MatchSeed = UGameplayStatics::GetIntOption(Options, TEXT("Seed"), MatchSeed);
+
+	if (UGameplayStatics::HasOption(Options, TEXT("Replay")))
+	{
+		ReplayToPlay = UGameplayStatics::ParseOption(Options, TEXT("Replay"));
+	}
+	if (UGameplayStatics::HasOption(Options, TEXT("RecordReplay")))
+	{
+		bRecordReplays = true;
+	}
+	if (UGameplayStatics::HasOption(Options, TEXT("ReplaySpeed")))
+	{
+		ReplaySpeed = FMath::Max(0.1f, FCString::Atof(*UGameplayStatics::ParseOption(Options, TEXT("ReplaySpeed"))));
+	}
 }
 
 void ARobotRallyGameMode::BeginPlay()
 {
 	Super::BeginPlay();
+	LoadReplayToPlay();
+	InitMatchRandomStreams();
 	BuildDeck();
 	ShuffleDeck();
 	SetupTestScene();
 }
 
+void ARobotRallyGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Let the last round reach the disk
+	ReplayWritePipe.WaitUntilEmpty();
+	Super::EndPlay(EndPlayReason);
+}
+
 void ARobotRallyGameMode::SetupTestScene()
 {
 	UWorld* World = GetWorld();
@@ -198,28 +293,31 @@ void ARobotRallyGameMode::SetupTestScene()
 	FActorSpawnParameters SpawnParams;
 	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
-	// Spawn scene lighting
-	ADirectionalLight* DirLight = World->SpawnActor<ADirectionalLight>(
-		ADirectionalLight::StaticClass(),
-		FVector(0.0f, 0.0f, 500.0f),
-		FRotator(-50.0f, -45.0f, 0.0f),
-		SpawnParams);
-	if (DirLight)
+	// Scene lighting (nothing renders on a dedicated server)
+	if (!IsNetMode(NM_DedicatedServer))
 	{
-		DirLight->GetLightComponent()->SetIntensity(4.0f);
-	}
+		ADirectionalLight* DirLight = World->SpawnActor<ADirectionalLight>(
+			ADirectionalLight::StaticClass(),
+			FVector(0.0f, 0.0f, 500.0f),
+			FRotator(-50.0f, -45.0f, 0.0f),
+			SpawnParams);
+		if (DirLight)
+		{
+			DirLight->GetLightComponent()->SetIntensity(4.0f);
+		}
 
-	ASkyLight* Sky = World->SpawnActor<ASkyLight>(
-		ASkyLight::StaticClass(),
-		FVector(0.0f, 0.0f, 500.0f),
-		FRotator::ZeroRotator,
-		SpawnParams);
-	if (Sky)
-	{
-		USkyLightComponent* SkyComp = Sky->GetLightComponent();
-		SkyComp->SetIntensity(1.5f);
-		SkyComp->SourceType = ESkyLightSourceType::SLS_SpecifiedCubemap;
-		SkyComp->RecaptureSky();
+		ASkyLight* Sky = World->SpawnActor<ASkyLight>(
+			ASkyLight::StaticClass(),
+			FVector(0.0f, 0.0f, 500.0f),
+			FRotator::ZeroRotator,
+			SpawnParams);
+		if (Sky)
+		{
+			USkyLightComponent* SkyComp = Sky->GetLightComponent();
+			SkyComp->SetIntensity(1.5f);
+			SkyComp->SourceType = ESkyLightSourceType::SLS_SpecifiedCubemap;
+			SkyComp->RecaptureSky();
+		}
 	}
 
 	// Spawn GridManager at origin
@@ -322,6 +420,15 @@ void ARobotRallyGameMode::SetupTestScene()
 		GridManagerInstance->SetWall(FIntVector(2, 6, 0), EGridDirection::North, true);
 		GridManagerInstance->SetWall(FIntVector(3, 5, 0), EGridDirection::East, true);
 
+		// Watching a replay: the recorded board replaces the test layout. The robots and seed
+		// already come from the replay, so a bad board ends the match instead of going live.
+		if (ReplayPlayback && !ApplyReplayBoard())
+		{
+			ShowEventMessage(TEXT("Replay board is corrupt, playback aborted."), FColor::Red);
+			EnterGameOver();
+			return;
+		}
+
 		// Spawn robots with controllers using the new spawn system
 		SpawnRobotsWithControllers();
 		StartProgrammingPhase();
@@ -332,7 +439,16 @@ void ARobotRallyGameMode::StartProgrammingPhase()
 {
 	CurrentState = EGameState::Programming;
 	CurrentRegister = 0;
-	GetWorld()->GetTimerManager().ClearTimer(MovementCheckTimerHandle);
+	GetWorld()->GetTimerManager().ClearTimer(RegisterDelayTimerHandle);
+	bWaitingForMovement = false;
+
+	// Replay playback: the next round comes from the recording, nobody programs
+	if (ReplayPlayback)
+	{
+		PlayNextReplayRound();
+		return;
+	}
+
 	DiscardHand();
 	DealHandsToAllRobots();
 
@@ -340,8 +456,9 @@ void ARobotRallyGameMode::StartProgrammingPhase()
 	ARobotRallyGameState* GS = GetGameState<ARobotRallyGameState>();
 	if (GS)
 	{
-		GS->Rep_CurrentGameState = CurrentState;
+		GS->SetCurrentGameState(CurrentState);
 		GS->Rep_CurrentRegister = CurrentRegister;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, Rep_CurrentRegister, GS);
 	}
 
 	// Sync hand cards to PlayerStates for all human players
@@ -352,6 +469,7 @@ void ARobotRallyGameMode::StartProgrammingPhase()
 
 	// Reset ready tracking
 	ReadyControllers.Empty();
+	PlanningSnapshot.Reset();
 
 	// Notify all AI controllers to start thinking
 	for (ARobotPawn* Robot : Robots)
@@ -365,11 +483,29 @@ void ARobotRallyGameMode::StartProgrammingPhase()
 		}
 	}
 
+	// Robots stay still until execution; let the net driver skip them
+	SetRobotsNetDormant(true);
+
 	ShowEventMessage(TEXT("Programming phase. Select 5 cards (1-9), then press E."), FColor::Cyan);
 }
 
+void ARobotRallyGameMode::SetRobotsNetDormant(bool bDormant)
+{
+	if (GetNetMode() == NM_Standalone) return;
+
+	for (ARobotPawn* Robot : Robots)
+	{
+		if (Robot)
+		{
+			Robot->SetNetDormancy(bDormant ? DORM_DormantAll : DORM_Awake);
+		}
+	}
+}
+
 void ARobotRallyGameMode::StartExecutionPhase()
 {
+	if (ReplayPlayback) return;
+
 	// Check that player's robot (Robot 0) has filled their registers
 	// Other robots are optional (will be skipped if not programmed)
 	if (Robots.IsValidIndex(0) && Robots[0]->bIsAlive)
@@ -396,364 +532,564 @@ void ARobotRallyGameMode::StartExecutionPhase()
 		}
 	}
 
-	CurrentState = EGameState::Executing;
+	EnterExecutionState();
 
-	// Sync GameState
-	ARobotRallyGameState* GS = GetGameState<ARobotRallyGameState>();
-	if (GS)
+	CommitAllRobotPrograms();
+	DiscardHand();
+
+	// Resolve the whole round instantly, then replay it as animation
+	if (GridManagerInstance)
 	{
-		GS->Rep_CurrentGameState = CurrentState;
+		FRallySimulator Sim = CreateSimulator();
+		RecordReplayRound(Sim);
+		Sim.ResolveRound(&RoundEvents);
 	}
 
-	CommitAllRobotPrograms();
-	DiscardHand();
+	UE_LOG(LogTemp, Log, TEXT("Resolved round: %d events"), RoundEvents.Num());
 
-	CurrentRegister = 0;
-	BuildExecutionQueue(0);
-	ProcessExecutionQueue();
+	ReplayNextStep();
 }
 
-void ARobotRallyGameMode::BuildExecutionQueue(int32 RegisterIndex)
+void ARobotRallyGameMode::EnterExecutionState()
 {
-	ExecutionQueue.Empty();
+	CurrentState = EGameState::Executing;
 
-	// Collect cards from all robots for this register
-	for (FRobotProgram& Program : RobotPrograms)
+	// Sync GameState
+	if (ARobotRallyGameState* GS = GetGameState<ARobotRallyGameState>())
 	{
-		if (!Program.Robot || !Program.Robot->bIsAlive) continue;
-		if (!Program.CommittedProgram.IsValidIndex(RegisterIndex)) continue;
-
-		FExecutionQueueEntry Entry;
-		Entry.Robot = Program.Robot;
-		Entry.Card = Program.CommittedProgram[RegisterIndex];
-		Entry.RegisterNumber = RegisterIndex;
-		ExecutionQueue.Add(Entry);
+		GS->SetCurrentGameState(CurrentState);
 	}
 
-	// Sort by priority (higher first)
-	ExecutionQueue.Sort();
+	SetRobotsNetDormant(false);
 
-	CurrentExecutionIndex = 0;
-
-	UE_LOG(LogTemp, Log, TEXT("Built execution queue for register %d: %d entries"),
-		RegisterIndex, ExecutionQueue.Num());
+	CurrentRegister = 0;
+	RoundEvents.Reset();
+	ReplayIndex = 0;
 }
 
-void ARobotRallyGameMode::ProcessExecutionQueue()
+void ARobotRallyGameMode::RecordReplayRound(const FRallySimulator& Sim)
 {
-	if (CurrentExecutionIndex >= ExecutionQueue.Num())
+	if (!bRecordReplays || ReplayPlayback) return;
+
+	if (!ReplayRecording)
 	{
-		// All cards in this register executed - process tile effects
-		ProcessAllRobotTileEffects();
-		return;
-	}
+		ReplayRecording = MakeUnique<FRallyReplay>();
+		ReplayRecording->BeginRecording(MatchSeed, Sim);
 
-	// Execute one robot at a time, priority order (highest first)
-	FExecutionQueueEntry& Entry = ExecutionQueue[CurrentExecutionIndex];
+		for (int32 i = 0; i < Robots.Num() && i < ReplayRecording->Robots.Num(); ++i)
+		{
+			const ARobotPawn* Robot = Robots[i];
+			if (!Robot) continue;
 
-	MovingRobots.Empty();
+			const ARobotAIController* AIController = Cast<ARobotAIController>(Robot->GetController());
+			FRallyReplayRobot& Entry = ReplayRecording->Robots[i];
+			Entry.ControllerType = static_cast<uint8>(AIController ? AIController->DifficultyLevel : ERobotControllerType::Player);
+			Entry.BodyColor = Robot->BodyColor.ToFColor(true);
+		}
 
-	if (Entry.Robot && Entry.Robot->bIsAlive)
-	{
-		int32 RobotIndex = Robots.Find(Entry.Robot);
-		ShowEventMessage(FString::Printf(TEXT("R%d: %s (P%d)"),
-			RobotIndex, *GetCardActionName(Entry.Card.Action), Entry.Card.Priority),
-			FColor::White);
+		// Make room for this one
+		if (MaxKeptReplays > 0)
+		{
+			FRallyReplay::PruneRecordings(MaxKeptReplays - 1);
+		}
 
-		ExecuteCardAction(Entry.Robot, Entry.Card.Action);
-		MovingRobots.Add(Entry.Robot);
+		ReplayRecordingPath = FRallyReplay::MakeRecordingPath(MatchSeed);
+		UE_LOG(LogTemp, Log, TEXT("Recording replay to %s"), *ReplayRecordingPath);
 	}
 
-	CurrentExecutionIndex++;
+	// Small enough to rewrite whole; a crashed server still leaves every finished round on disk.
+	// Encoded here, written off the game thread in order.
+	ReplayRecording->RecordRound(Sim);
+	TArray<uint8> Bytes;
+	if (!ReplayRecording->SaveToBytes(Bytes))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Could not encode replay %s"), *ReplayRecordingPath);
+		return;
+	}
 
-	// Wait for this robot's movement to complete, then process next
-	GetWorld()->GetTimerManager().SetTimer(
-		MovementCheckTimerHandle,
-		this,
-		&ARobotRallyGameMode::CheckParallelMovementComplete,
-		0.1f,
-		true);
+	ReplayWritePipe.Launch(UE_SOURCE_LOCATION, [Bytes = MoveTemp(Bytes), Path = ReplayRecordingPath]()
+	{
+		if (!FFileHelper::SaveArrayToFile(Bytes, *Path))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Could not write replay %s"), *Path);
+		}
+	}, LowLevelTasks::ETaskPriority::BackgroundNormal);
 }
 
-void ARobotRallyGameMode::CheckParallelMovementComplete()
+bool ARobotRallyGameMode::LoadReplayToPlay()
 {
-	// Remove robots that are no longer moving
-	for (auto It = MovingRobots.CreateIterator(); It; ++It)
+	if (ReplayToPlay.IsEmpty()) return false;
+
+	FString Path = ReplayToPlay;
+	if (FPaths::IsRelative(Path))
 	{
-		ARobotPawn* Robot = *It;
-		if (!Robot || !Robot->RobotMovement) continue;
+		Path = FPaths::ProjectSavedDir() / TEXT("Replays") / Path;
+	}
 
-		bool bStillMoving = Robot->RobotMovement->IsMoving() ||
-		                   Robot->RobotMovement->IsRotating();
-		if (!bStillMoving)
-		{
-			It.RemoveCurrent();
-		}
+	TUniquePtr<FRallyReplay> Replay = MakeUnique<FRallyReplay>();
+	FString Error;
+	if (!Replay->LoadFromFile(Path, Error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay playback: %s"), *Error);
+		return false;
 	}
 
-	// Robot finished moving - continue to next robot in queue
-	if (MovingRobots.Num() == 0)
+	// Same seed and robots as the recorded match
+	MatchSeed = Replay->MatchSeed;
+	RobotSpawnConfigs.Reset();
+	for (const FRallyReplayRobot& Robot : Replay->Robots)
 	{
-		GetWorld()->GetTimerManager().ClearTimer(MovementCheckTimerHandle);
-		ProcessExecutionQueue();
+		FRobotSpawnData& Config = RobotSpawnConfigs.AddDefaulted_GetRef();
+		Config.StartPosition = FIntVector(Robot.State.X, Robot.State.Y, 0);
+		Config.StartFacing = static_cast<EGridDirection>(Robot.State.Facing & 3);
+		Config.ControllerType = static_cast<ERobotControllerType>(
+			FMath::Min(Robot.ControllerType, static_cast<uint8>(ERobotControllerType::AI_Hard)));
+		Config.BodyColor = FLinearColor(Robot.BodyColor);
 	}
+
+	UE_LOG(LogTemp, Log, TEXT("Replay playback: %s (seed %d, %d robots, %d rounds, speed x%.1f)"),
+		*Path, Replay->MatchSeed, Replay->Robots.Num(), Replay->Rounds.Num(), ReplaySpeed);
+
+	ReplayPlayback = MoveTemp(Replay);
+	PlaybackSim.Reset();
+	PlaybackRound = 0;
+	return true;
 }
 
-void ARobotRallyGameMode::ExecuteCardAction(ARobotPawn* Robot, ECardAction Action)
+bool ARobotRallyGameMode::ApplyReplayBoard()
 {
-	if (!Robot || !Robot->bIsAlive) return;
+	if (!ReplayPlayback || !GridManagerInstance) return false;
 
-	switch (Action)
+	int32 BoardWidth = 0;
+	int32 BoardHeight = 0;
+	TArray<FPackedTile> Tiles;
+	if (FTileGrid::HashBoardBlob(ReplayPlayback->BoardBlob) != ReplayPlayback->BoardHash
+		|| !FTileGrid::ReadBoardBlob(ReplayPlayback->BoardBlob, BoardWidth, BoardHeight, Tiles))
 	{
-	case ECardAction::Move1:
-		Robot->ExecuteMoveCommand(1);
-		break;
-	case ECardAction::Move2:
-		Robot->ExecuteMoveCommand(2);
-		break;
-	case ECardAction::Move3:
-		Robot->ExecuteMoveCommand(3);
-		break;
-	case ECardAction::MoveBack:
-		Robot->ExecuteMoveCommand(-1);
-		break;
-	case ECardAction::RotateRight:
-		Robot->ExecuteRotateCommand(1);
-		break;
-	case ECardAction::RotateLeft:
-		Robot->ExecuteRotateCommand(-1);
-		break;
-	case ECardAction::UTurn:
-		Robot->ExecuteRotateCommand(2);
-		break;
+		UE_LOG(LogTemp, Error, TEXT("Replay playback: board does not match hash %016llx"), ReplayPlayback->BoardHash);
+		return false;
 	}
-}
 
-void ARobotRallyGameMode::ProcessTileEffects()
-{
-	// Legacy function for manual WASD movement - process all robots
-	ProcessAllRobotTileEffects();
+	GridManagerInstance->ApplyBoard(BoardWidth, BoardHeight, Tiles);
+	return true;
 }
 
-void ARobotRallyGameMode::ProcessAllRobotTileEffects()
+void ARobotRallyGameMode::PlayNextReplayRound()
 {
-	bProcessingTileEffects = true;
+	if (!GridManagerInstance) return;
 
-	// Process tile effects for all robots
-	for (ARobotPawn* Robot : Robots)
+	if (!PlaybackSim)
+	{
+		PlaybackSim = MakeUnique<FRallySimulator>(ReplayPlayback->CreateSimulator(GridManagerInstance->GetTileGrid()));
+		UGameplayStatics::SetGlobalTimeDilation(this, ReplaySpeed);
+	}
+
+	const int32 NumRounds = ReplayPlayback->Rounds.Num();
+	if (PlaybackRound >= NumRounds || PlaybackSim->IsGameOver())
 	{
-		if (Robot && Robot->bIsAlive)
+		ShowEventMessage(TEXT("Replay finished."), FColor::Cyan);
+		EnterGameOver();
+		return;
+	}
+
+	// The recorded match left the rules here (e.g. debug moves); continue from where it did
+	const FRallyReplayRound& Round = ReplayPlayback->Rounds[PlaybackRound];
+	if (Round.Keyframe.Num() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Replay round %d starts from a keyframe"), PlaybackRound + 1);
+		for (int32 i = 0; i < Robots.Num() && i < Round.Keyframe.Num(); ++i)
 		{
-			ProcessRobotTileEffects(Robot);
+			ARobotPawn* Robot = Robots[i];
+			if (!Robot || !Robot->RobotMovement) continue;
+
+			// The whole state, so the pawns match what the simulator resolves from
+			const FRallyRobotState& State = Round.Keyframe[i];
+			Robot->RobotMovement->TeleportToGridPosition(State.X, State.Y);
+			Robot->RobotMovement->SnapToFacing(static_cast<EGridDirection>(State.Facing & 3));
+			Robot->MaxHealth = State.MaxHealth;
+			Robot->SetStatus(State.Health, State.Lives, State.Checkpoint,
+				FIntVector(State.RespawnX, State.RespawnY, 0), State.bAlive);
 		}
 	}
 
-	// Process conveyors
-	ProcessAllConveyors();
+	ShowEventMessage(FString::Printf(TEXT("Replay round %d/%d"), PlaybackRound + 1, NumRounds), FColor::Cyan);
+
+	EnterExecutionState();
+	ReplayPlayback->ResolveRound(*PlaybackSim, PlaybackRound++, &RoundEvents);
+	ReplayNextStep();
 }
 
-void ARobotRallyGameMode::ProcessRobotTileEffects(ARobotPawn* Robot)
+FRallySimulator ARobotRallyGameMode::CreateSimulator() const
 {
-	if (!Robot || !Robot->bIsAlive || !GridManagerInstance) return;
-
-	FIntVector CurrentPos(Robot->GridX, Robot->GridY, 0);
-	FTileData TileData = GridManagerInstance->GetTileData(CurrentPos);
+	check(GridManagerInstance);
 
-	int32 RobotIndex = Robots.Find(Robot);
+	FRallySimulator Sim(GridManagerInstance->GetTileGrid(), GridManagerInstance->GetTotalCheckpoints());
 
-	switch (TileData.TileType)
+	for (ARobotPawn* Robot : Robots)
 	{
-	case ETileType::Pit:
-		ShowEventMessage(FString::Printf(TEXT("R%d fell into pit!"), RobotIndex), FColor::Red);
-		Robot->ApplyDamage(Robot->MaxHealth);
-		break;
-
-	case ETileType::Laser:
-		ShowEventMessage(FString::Printf(TEXT("R%d hit by laser (-1 HP)"), RobotIndex), FColor::Orange);
-		Robot->ApplyDamage(1);
-		break;
+		FRallyRobotState State;
+		if (Robot)
+		{
+			const FIntVector Respawn = Robot->GetRespawnPosition();
+			State.X = Robot->GridX;
+			State.Y = Robot->GridY;
+			State.Facing = Robot->RobotMovement
+				? static_cast<uint8>(Robot->RobotMovement->GetFacingDirection()) : 0;
+			State.Health = Robot->Health;
+			State.MaxHealth = Robot->MaxHealth;
+			State.Lives = Robot->Lives;
+			State.Checkpoint = Robot->CurrentCheckpoint;
+			State.RespawnX = Respawn.X;
+			State.RespawnY = Respawn.Y;
+			State.bAlive = Robot->bIsAlive;
+		}
+		else
+		{
+			State.bAlive = false;
+		}
 
-	case ETileType::Checkpoint:
-		Robot->ReachCheckpoint(TileData.CheckpointNumber);
-		break;
+		const int32 Index = Sim.AddRobot(State);
 
-	default:
-		break;
+		const FRobotProgram* Program = RobotPrograms.FindByPredicate([Robot](const FRobotProgram& P)
+		{
+			return P.Robot == Robot;
+		});
+		if (Robot && Program)
+		{
+			FRallyProgram SimProgram;
+			for (const FRobotCard& Card : Program->CommittedProgram)
+			{
+				SimProgram.Cards.Add({ Card.Action, Card.Priority });
+			}
+			Sim.SetProgram(Index, SimProgram);
+		}
 	}
+
+	return Sim;
 }
 
-void ARobotRallyGameMode::ProcessAllConveyors()
+TSharedRef<const FRallyPlanningSnapshot> ARobotRallyGameMode::GetPlanningSnapshot()
 {
-	// Process conveyors for each robot separately
-	for (ARobotPawn* Robot : Robots)
+	if (!PlanningSnapshot.IsValid())
 	{
-		if (!Robot || !Robot->bIsAlive) continue;
-
-		ProcessRobotConveyors(Robot);
+		PlanningSnapshot = MakeShared<const FRallyPlanningSnapshot>(CreateSimulator());
 	}
-
-	OnTileEffectsComplete();
+	return PlanningSnapshot.ToSharedRef();
 }
 
-void ARobotRallyGameMode::ProcessRobotConveyors(ARobotPawn* Robot)
+ARobotPawn* ARobotRallyGameMode::FindRobotAt(int32 X, int32 Y, const ARobotPawn* IgnoreRobot) const
 {
-	if (!Robot || !Robot->bIsAlive || !GridManagerInstance) return;
+	if (!GridManagerInstance) return FindRobotAtSlow(X, Y, IgnoreRobot);
 
-	FIntVector CurrentPos(Robot->GridX, Robot->GridY, 0);
-	ETileType Type = GridManagerInstance->GetTileType(CurrentPos);
+	const FTileGrid& Grid = GridManagerInstance->GetTileGrid();
+	if (!Grid.IsInBounds(X, Y) || !RobotOccupancy.IsValidIndex(Grid.ToIndex(X, Y))) return nullptr;
 
-	// Only move if currently on a conveyor
-	if (!AGridManager::IsConveyor(Type)) return;
+	// Empty tile: nothing stands here
+	ARobotPawn* Occupant = RobotOccupancy[Grid.ToIndex(X, Y)];
+	if (!Occupant) return nullptr;
 
-	// Calculate new position based on conveyor direction (move only ONE tile)
-	int32 DX = 0, DY = 0;
-	switch (Type)
+	if (Occupant != IgnoreRobot && Occupant->bIsAlive && Occupant->GridX == X && Occupant->GridY == Y)
 	{
-	case ETileType::ConveyorNorth: DX = 1; break;
-	case ETileType::ConveyorSouth: DX = -1; break;
-	case ETileType::ConveyorEast: DY = 1; break;
-	case ETileType::ConveyorWest: DY = -1; break;
+		return Occupant;
 	}
 
-	FIntVector NewPos(CurrentPos.X + DX, CurrentPos.Y + DY, 0);
+	// Stacked robots (conveyors/respawns may share a tile) or a dead occupant
+	return FindRobotAtSlow(X, Y, IgnoreRobot);
+}
 
-	// Check if wall blocks conveyor movement
-	if (GridManagerInstance->IsMovementBlocked(CurrentPos, NewPos))
+ARobotPawn* ARobotRallyGameMode::FindRobotAtSlow(int32 X, int32 Y, const ARobotPawn* IgnoreRobot) const
+{
+	for (ARobotPawn* Robot : Robots)
 	{
-		int32 RobotIndex = Robots.Find(Robot);
-		ShowEventMessage(FString::Printf(TEXT("R%d blocked by wall on conveyor"), RobotIndex), FColor::Yellow);
-		return;
+		if (Robot && Robot != IgnoreRobot && Robot->bIsAlive && Robot->GridX == X && Robot->GridY == Y)
+		{
+			return Robot;
+		}
 	}
+	return nullptr;
+}
 
-	if (GridManagerInstance->IsValidTile(NewPos))
-	{
-		FVector NewWorldPos = GridManagerInstance->GridToWorld(NewPos);
-		Robot->RobotMovement->MoveToWorldPosition(NewWorldPos);
-		Robot->RobotMovement->SetGridPosition(NewPos.X, NewPos.Y);
+void ARobotRallyGameMode::NotifyRobotMoved(ARobotPawn* Robot, FIntVector From)
+{
+	if (!Robot || !GridManagerInstance) return;
 
-		int32 RobotIndex = Robots.Find(Robot);
-		ShowEventMessage(FString::Printf(TEXT("R%d moved by conveyor"), RobotIndex), FColor::Cyan);
+	const FTileGrid& Grid = GridManagerInstance->GetTileGrid();
+	if (RobotOccupancy.Num() != Grid.Tiles.Num()) return;
 
-		// Check new tile for checkpoint
-		FTileData NewTile = GridManagerInstance->GetTileData(NewPos);
-		if (NewTile.TileType == ETileType::Checkpoint)
+	// Vacate the old tile, handing it to any robot still stacked there
+	if (Grid.IsInBounds(From.X, From.Y))
+	{
+		ARobotPawn*& OldCell = RobotOccupancy[Grid.ToIndex(From.X, From.Y)];
+		if (OldCell == Robot)
 		{
-			Robot->ReachCheckpoint(NewTile.CheckpointNumber);
+			OldCell = nullptr;
+			for (ARobotPawn* Other : Robots)
+			{
+				if (Other && Other != Robot && Other->GridX == From.X && Other->GridY == From.Y)
+				{
+					OldCell = Other;
+					break;
+				}
+			}
 		}
 	}
+
+	if (Grid.IsInBounds(Robot->GridX, Robot->GridY))
+	{
+		RobotOccupancy[Grid.ToIndex(Robot->GridX, Robot->GridY)] = Robot;
+	}
 }
 
-void ARobotRallyGameMode::CheckWinLoseConditions()
+void ARobotRallyGameMode::RebuildOccupancy()
 {
+	RobotOccupancy.Reset();
 	if (!GridManagerInstance) return;
 
-	int32 TotalCheckpoints = GridManagerInstance->GetTotalCheckpoints();
-	int32 AliveRobots = 0;
+	const FTileGrid& Grid = GridManagerInstance->GetTileGrid();
+	RobotOccupancy.SetNumZeroed(Grid.Tiles.Num());
 
-	for (int32 i = 0; i < Robots.Num(); ++i)
+	for (ARobotPawn* Robot : Robots)
 	{
-		ARobotPawn* Robot = Robots[i];
-		if (!Robot) continue;
+		if (Robot && Grid.IsInBounds(Robot->GridX, Robot->GridY))
+		{
+			RobotOccupancy[Grid.ToIndex(Robot->GridX, Robot->GridY)] = Robot;
+		}
+	}
+}
 
-		if (Robot->bIsAlive)
+bool ARobotRallyGameMode::IsReplayBarrier(ERallyEventType Type)
+{
+	// These events wait for all previous movement to settle (a robot carried into a pit lands first)
+	return Type == ERallyEventType::CardStart
+		|| Type == ERallyEventType::PitFall
+		|| Type == ERallyEventType::BoardElements
+		|| Type == ERallyEventType::RegisterEnd;
+}
+
+void ARobotRallyGameMode::ReplayNextStep()
+{
+	while (ReplayIndex < RoundEvents.Num())
+	{
+		const FRallyEvent Event = RoundEvents[ReplayIndex];
+
+		if (IsReplayBarrier(Event.Type) && !PruneSettledRobots())
 		{
-			AliveRobots++;
+			// OnRobotMovementFinished resumes the replay when the last robot settles
+			bWaitingForMovement = true;
+			return;
+		}
 
-			// Win condition: first robot to collect all checkpoints wins
-			if (TotalCheckpoints > 0 && Robot->CurrentCheckpoint >= TotalCheckpoints)
-			{
-				ShowEventMessage(FString::Printf(TEXT("VICTORY! Robot %d collected all %d checkpoints!"),
-					i, TotalCheckpoints), FColor::Green);
-				CurrentState = EGameState::GameOver;
-				if (ARobotRallyGameState* GS = GetGameState<ARobotRallyGameState>())
-				{
-					GS->Rep_CurrentGameState = CurrentState;
-				}
-				return;
-			}
+		ReplayIndex++;
+		ApplyReplayEvent(Event);
+
+		if (CurrentState == EGameState::GameOver) return;
+
+		// Short pause between registers
+		if (Event.Type == ERallyEventType::RegisterEnd && ReplayIndex < RoundEvents.Num() && RegisterPauseSeconds > 0.0f)
+		{
+			GetWorld()->GetTimerManager().SetTimer(
+				RegisterDelayTimerHandle,
+				this,
+				&ARobotRallyGameMode::ReplayNextStep,
+				RegisterPauseSeconds,
+				false);
+			return;
 		}
 	}
 
-	// Lose condition: all robots destroyed
-	if (AliveRobots == 0)
+	OnReplayFinished();
+}
+
+void ARobotRallyGameMode::ApplyReplayEvent(const FRallyEvent& Event)
+{
+	ARobotPawn* Robot = Robots.IsValidIndex(Event.Robot) ? Robots[Event.Robot] : nullptr;
+
+	auto MoveRobotTo = [this, Robot](int32 X, int32 Y)
 	{
-		ShowEventMessage(TEXT("GAME OVER - All robots destroyed!"), FColor::Red);
-		CurrentState = EGameState::GameOver;
-		if (ARobotRallyGameState* GS = GetGameState<ARobotRallyGameState>())
+		if (!Robot || !Robot->RobotMovement || !GridManagerInstance) return;
+
+		Robot->RobotMovement->MoveToWorldPosition(GridManagerInstance->GridToWorld(FIntVector(X, Y, 0)));
+		Robot->RobotMovement->SetGridPosition(X, Y);
+		MovingRobots.Add(Robot);
+	};
+
+	switch (Event.Type)
+	{
+	case ERallyEventType::CardStart:
+		MovingRobots.Empty();
+		PostGameEvent(ERallyGameEventType::CardPlayed, Event.Robot, Event.Param, Event.Value);
+		break;
+
+	case ERallyEventType::Move:
+		MoveRobotTo(Event.X, Event.Y);
+		break;
+
+	case ERallyEventType::Rotate:
+		if (Robot && Robot->RobotMovement)
 		{
-			GS->Rep_CurrentGameState = CurrentState;
+			Robot->RobotMovement->RotateInGrid(Event.Param);
+			MovingRobots.Add(Robot);
 		}
+		break;
+
+	case ERallyEventType::BoardElements:
+		bProcessingTileEffects = true;
+		break;
+
+	case ERallyEventType::PitFall:
+		PostGameEvent(ERallyGameEventType::PitFall, Event.Robot);
+		if (Robot) Robot->ApplyDamage(Event.Value);
+		break;
+
+	case ERallyEventType::LaserHit:
+		PostGameEvent(ERallyGameEventType::LaserHit, Event.Robot, Event.Value);
+		if (Robot) Robot->ApplyDamage(Event.Value);
+		break;
+
+	case ERallyEventType::Destroyed:
+	case ERallyEventType::Respawn:
+		// Reported by ARobotPawn::ApplyDamage
+		break;
+
+	case ERallyEventType::Checkpoint:
+		if (Robot) Robot->ReachCheckpoint(Event.Param);
+		break;
+
+	case ERallyEventType::ConveyorMove:
+		MoveRobotTo(Event.X, Event.Y);
+		PostGameEvent(ERallyGameEventType::ConveyorMove, Event.Robot);
+		break;
+
+	case ERallyEventType::ConveyorBlocked:
+		PostGameEvent(ERallyGameEventType::ConveyorBlocked, Event.Robot, Event.Param);
+		break;
+
+	case ERallyEventType::RegisterEnd:
+		bProcessingTileEffects = false;
+		CurrentRegister = Event.Register + 1;
+		FlushGameEvents();
+		break;
+
+	case ERallyEventType::Victory:
+		PostGameEvent(ERallyGameEventType::Victory, Event.Robot, Event.Value);
+		EnterGameOver();
+		break;
+
+	case ERallyEventType::AllDestroyed:
+		PostGameEvent(ERallyGameEventType::AllDestroyed, Event.Robot);
+		EnterGameOver();
+		break;
 	}
 }
 
-void ARobotRallyGameMode::OnTileEffectsComplete()
+void ARobotRallyGameMode::OnReplayFinished()
 {
 	bProcessingTileEffects = false;
-	CheckWinLoseConditions();
-
-	if (CurrentState == EGameState::GameOver) return;
+	RoundEvents.Reset();
+	ReplayIndex = 0;
+	FlushGameEvents();
 
 	if (CurrentState == EGameState::Executing)
 	{
-		// All robots in this register moved and tile effects processed
-		// Advance to next register
-		CurrentRegister++;
+		ShowEventMessage(TEXT("All registers executed!"), FColor::Green);
+		StartProgrammingPhase();
+	}
+}
 
-		if (CurrentRegister >= NUM_REGISTERS)
+bool ARobotRallyGameMode::PruneSettledRobots()
+{
+	// Drop robots that already settled (or went away); true when nothing is left moving
+	for (auto It = MovingRobots.CreateIterator(); It; ++It)
+	{
+		ARobotPawn* Robot = *It;
+		if (!Robot || !Robot->RobotMovement ||
+			(!Robot->RobotMovement->IsMoving() && !Robot->RobotMovement->IsRotating()))
 		{
-			ShowEventMessage(TEXT("All registers executed!"), FColor::Green);
-			StartProgrammingPhase();
-			return;
+			It.RemoveCurrent();
 		}
+	}
+	return MovingRobots.Num() == 0;
+}
 
-		// Build queue for next register after short delay
-		FTimerHandle DelayHandle;
-		GetWorld()->GetTimerManager().SetTimer(
-			DelayHandle,
-			[this]()
-			{
-				BuildExecutionQueue(CurrentRegister);
-				ProcessExecutionQueue();
-			},
-			0.3f,
-			false);
+void ARobotRallyGameMode::OnRobotMovementFinished(URobotMovementComponent* MovementComponent)
+{
+	ARobotPawn* Robot = MovementComponent ? Cast<ARobotPawn>(MovementComponent->GetOwner()) : nullptr;
+	MovingRobots.Remove(Robot);
+
+	if (!PruneSettledRobots()) return;
+
+	if (bWaitingForMovement)
+	{
+		bWaitingForMovement = false;
+		ReplayNextStep();
+	}
+	else if (bWaitingForManualMove)
+	{
+		bWaitingForManualMove = false;
+		ProcessTileEffects();
 	}
 }
 
-void ARobotRallyGameMode::StartManualMoveTick()
+void ARobotRallyGameMode::EnterGameOver()
 {
+	CurrentState = EGameState::GameOver;
+	bProcessingTileEffects = false;
+
+	// The deciding register ends without a RegisterEnd: send its events (and the result) now,
+	// and stop batching so later events go out immediately
+	RoundEvents.Reset();
+	ReplayIndex = 0;
+	FlushGameEvents();
+
+	if (ReplayPlayback)
+	{
+		UGameplayStatics::SetGlobalTimeDilation(this, 1.0f);
+	}
+
+	if (ARobotRallyGameState* GS = GetGameState<ARobotRallyGameState>())
+	{
+		GS->SetCurrentGameState(CurrentState);
+	}
+}
+
+void ARobotRallyGameMode::ProcessTileEffects()
+{
+	// Manual WASD movement: resolve board elements for the current positions and replay them
+	if (!GridManagerInstance) return;
+
 	bProcessingTileEffects = true;
+	MovingRobots.Empty();
+	RoundEvents.Reset();
+	ReplayIndex = 0;
+
+	FRallySimulator Sim = CreateSimulator();
+	Sim.ResolveBoardElements(&RoundEvents);
 
-	// Poll for movement completion, then trigger tile effects
-	GetWorld()->GetTimerManager().SetTimer(
-		ManualMoveTimerHandle,
-		this,
-		&ARobotRallyGameMode::CheckManualMoveComplete,
-		0.05f,
-		true);
+	ReplayNextStep();
 }
 
-void ARobotRallyGameMode::CheckManualMoveComplete()
+void ARobotRallyGameMode::WaitForManualMove()
 {
-	// Check if any robot is still moving (for WASD manual movement)
-	bool bAnyMoving = false;
+	bProcessingTileEffects = true;
+
+	// Track every robot the move set in motion (the mover and anything it pushed)
+	MovingRobots.Empty();
 	for (ARobotPawn* Robot : Robots)
 	{
-		if (Robot && Robot->RobotMovement)
+		if (Robot && Robot->RobotMovement &&
+			(Robot->RobotMovement->IsMoving() || Robot->RobotMovement->IsRotating()))
 		{
-			if (Robot->RobotMovement->IsMoving() || Robot->RobotMovement->IsRotating())
-			{
-				bAnyMoving = true;
-				break;
-			}
+			MovingRobots.Add(Robot);
 		}
 	}
 
-	if (!bAnyMoving)
+	if (MovingRobots.Num() == 0)
 	{
-		GetWorld()->GetTimerManager().ClearTimer(ManualMoveTimerHandle);
 		ProcessTileEffects();
+		return;
 	}
+
+	bWaitingForManualMove = true;
 }
 
 FString ARobotRallyGameMode::GetCardActionName(ECardAction Action)
@@ -773,17 +1109,23 @@ FString ARobotRallyGameMode::GetCardActionName(ECardAction Action)
 
 void ARobotRallyGameMode::BuildDeck()
 {
-	Deck.Empty();
-	Deck.Reserve(DECK_SIZE);
+	BuildStandardDeck(Deck);
+	UE_LOG(LogTemp, Log, TEXT("Deck built: %d cards"), Deck.Num());
+}
+
+void ARobotRallyGameMode::BuildStandardDeck(TArray<FRobotCard>& OutDeck)
+{
+	OutDeck.Empty();
+	OutDeck.Reserve(DECK_SIZE);
 
-	auto AddCards = [this](ECardAction Action, int32 Count, int32 StartPriority, int32 Step)
+	auto AddCards = [&OutDeck](ECardAction Action, int32 Count, int32 StartPriority, int32 Step)
 	{
 		for (int32 i = 0; i < Count; ++i)
 		{
 			FRobotCard Card;
 			Card.Action = Action;
 			Card.Priority = StartPriority + i * Step;
-			Deck.Add(Card);
+			OutDeck.Add(Card);
 		}
 	};
 
@@ -795,20 +1137,59 @@ void ARobotRallyGameMode::BuildDeck()
 	AddCards(ECardAction::Move1,      18, 490,  10);  // 490-660
 	AddCards(ECardAction::Move2,      12, 670,  10);  // 670-780
 	AddCards(ECardAction::Move3,       6, 790,  10);  // 790-840
+}
 
-	UE_LOG(LogTemp, Log, TEXT("Deck built: %d cards"), Deck.Num());
+void ARobotRallyGameMode::InitMatchRandomStreams()
+{
+	if (MatchSeed == 0)
+	{
+		FRandomStream SeedSource;
+		SeedSource.GenerateNewSeed();
+		MatchSeed = SeedSource.GetCurrentSeed();
+		if (MatchSeed == 0) MatchSeed = 1;
+	}
+
+	DeckStream.Initialize(DeriveStreamSeed(MatchSeed, 0));
+	HazardStream.Initialize(DeriveStreamSeed(MatchSeed, 1));
+
+	if (ARobotRallyGameState* GS = GetGameState<ARobotRallyGameState>())
+	{
+		GS->Rep_MatchSeed = MatchSeed;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, Rep_MatchSeed, GS);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Match seed: %d"), MatchSeed);
+}
+
+int32 ARobotRallyGameMode::DeriveStreamSeed(int32 InMatchSeed, uint32 Salt)
+{
+	// Salts: 0 deck, 1 hazards, 2 + robot index for AI controllers
+	return static_cast<int32>(HashCombine(GetTypeHash(InMatchSeed), GetTypeHash(Salt + 0x9E3779B9u)));
 }
 
 void ARobotRallyGameMode::ShuffleDeck()
+{
+	ShuffleCards(Deck, DeckStream);
+}
+
+void ARobotRallyGameMode::ShuffleCards(TArray<FRobotCard>& Cards, FRandomStream& Stream)
 {
 	// Fisher-Yates shuffle
-	for (int32 i = Deck.Num() - 1; i > 0; --i)
+	for (int32 i = Cards.Num() - 1; i > 0; --i)
 	{
-		int32 j = FMath::RandRange(0, i);
-		Deck.Swap(i, j);
+		int32 j = Stream.RandRange(0, i);
+		Cards.Swap(i, j);
 	}
 }
 
+int32 ARobotRallyGameMode::GetHandSize(int32 Health, int32 MaxHealth)
+{
+	// Hand size depends on robot damage
+	int32 Damage = MaxHealth - Health;
+	int32 LockedCards = FMath::Max(0, Damage - 4);  // 5+ damage locks cards
+	return FMath::Clamp(BASE_HAND_SIZE - LockedCards, MIN_HAND_SIZE, BASE_HAND_SIZE);
+}
+
 void ARobotRallyGameMode::DealHandsToAllRobots()
 {
 	UE_LOG(LogTemp, Log, TEXT("DealHandsToAllRobots: %d programs"), RobotPrograms.Num());
@@ -829,10 +1210,7 @@ void ARobotRallyGameMode::DealHandsToAllRobots()
 			continue;
 		}
 
-		// Hand size depends on robot damage
-		int32 Damage = Program.Robot->MaxHealth - Program.Robot->Health;
-		int32 LockedCards = FMath::Max(0, Damage - 4);  // 5+ damage locks cards
-		int32 HandSize = FMath::Clamp(BASE_HAND_SIZE - LockedCards, MIN_HAND_SIZE, BASE_HAND_SIZE);
+		int32 HandSize = GetHandSize(Program.Robot->Health, Program.Robot->MaxHealth);
 
 		Program.HandCards.Empty();
 		Program.HandCards.Reserve(HandSize);
@@ -908,10 +1286,8 @@ void ARobotRallyGameMode::SelectCardFromHand(ARobotPawn* Robot, int32 HandIndex)
 			Program->RegisterSlots[i] = HandIndex;
 
 			FRobotCard& Card = Program->HandCards[HandIndex];
-			ShowEventMessage(FString::Printf(TEXT("Robot %d: R%d = %s (P%d)"),
-				Robots.Find(Robot), i + 1,
-				*GetCardActionName(Card.Action), Card.Priority),
-				FColor::Green);
+			PostGameEvent(ERallyGameEventType::CardSelected, Robots.Find(Robot), i,
+				static_cast<int32>(Card.Action), Card.Priority);
 
 			// Sync to PlayerState for HUD replication
 			SyncPlayerStateHand(Robot);
@@ -939,7 +1315,7 @@ void ARobotRallyGameMode::UndoLastSelection()
 	{
 		if (Program->RegisterSlots[i] != -1)
 		{
-			ShowEventMessage(FString::Printf(TEXT("Cleared R%d"), i + 1), FColor::Yellow);
+			PostGameEvent(ERallyGameEventType::RegisterCleared, 0, i);
 			Program->RegisterSlots[i] = -1;
 
 			// Sync to PlayerState for HUD replication
@@ -959,6 +1335,57 @@ bool ARobotRallyGameMode::IsCardInRegister(const FRobotProgram* Program, int32 H
 	return false;
 }
 
+bool ARobotRallyGameMode::SubmitProgram(ARobotPawn* Robot, TConstArrayView<int32> HandIndices, FString& OutError)
+{
+	if (CurrentState != EGameState::Programming)
+	{
+		OutError = TEXT("Not in programming phase!");
+		return false;
+	}
+
+	FRobotProgram* Program = RobotPrograms.FindByPredicate([Robot](const FRobotProgram& P)
+	{
+		return P.Robot == Robot;
+	});
+
+	if (!Robot || !Program || HandIndices.Num() != NUM_REGISTERS)
+	{
+		OutError = TEXT("Invalid program!");
+		return false;
+	}
+
+	// Check every slot before touching the program
+	for (int32 i = 0; i < NUM_REGISTERS; ++i)
+	{
+		const int32 HandIndex = HandIndices[i];
+		if (HandIndex == -1) continue;
+
+		if (!Program->HandCards.IsValidIndex(HandIndex))
+		{
+			OutError = FString::Printf(TEXT("R%d: card %d is not in your hand!"), i + 1, HandIndex + 1);
+			return false;
+		}
+
+		for (int32 j = 0; j < i; ++j)
+		{
+			if (HandIndices[j] == HandIndex)
+			{
+				OutError = FString::Printf(TEXT("R%d: card %d is already in R%d!"), i + 1, HandIndex + 1, j + 1);
+				return false;
+			}
+		}
+	}
+
+	for (int32 i = 0; i < NUM_REGISTERS; ++i)
+	{
+		Program->RegisterSlots[i] = HandIndices[i];
+	}
+
+	// The hand is unchanged, so only the registers replicate
+	SyncPlayerStateHand(Robot);
+	return true;
+}
+
 void ARobotRallyGameMode::CommitAllRobotPrograms()
 {
 	for (FRobotProgram& Program : RobotPrograms)
@@ -1069,11 +1496,13 @@ void ARobotRallyGameMode::SpawnRobotsWithControllers()
 			NewRobot->GridX = SpawnGrid.X;
 			NewRobot->GridY = SpawnGrid.Y;
 			NewRobot->BodyColor = Config.BodyColor;
+			MARK_PROPERTY_DIRTY_FROM_NAME(ARobotPawn, BodyColor, NewRobot);
 
 			if (NewRobot->RobotMovement)
 			{
 				NewRobot->RobotMovement->GridManager = GridManagerInstance;
 				NewRobot->RobotMovement->InitializeGridPosition(SpawnGrid.X, SpawnGrid.Y, Config.StartFacing);
+				NewRobot->RobotMovement->OnMovementFinished.AddDynamic(this, &ARobotRallyGameMode::OnRobotMovementFinished);
 			}
 
 			// Assign controller
@@ -1126,6 +1555,7 @@ void ARobotRallyGameMode::SpawnRobotsWithControllers()
 						if (ARobotAIController* AICtrl = Cast<ARobotAIController>(NewController))
 						{
 							AICtrl->DifficultyLevel = Config.ControllerType;
+							AICtrl->InitRandomStream(DeriveStreamSeed(MatchSeed, 2 + Robots.Num()));
 						}
 
 						NewController->Possess(NewRobot);
@@ -1145,29 +1575,17 @@ void ARobotRallyGameMode::SpawnRobotsWithControllers()
 		}
 	}
 
+	RebuildOccupancy();
+
 	// Populate GameState with robot list and grid data
 	ARobotRallyGameState* GS = GetGameState<ARobotRallyGameState>();
 	if (GS)
 	{
 		GS->AllRobots = Robots;
-		GS->Rep_GridWidth = GridManagerInstance->Width;
-		GS->Rep_GridHeight = GridManagerInstance->Height;
-		GS->Rep_TotalCheckpoints = GridManagerInstance->GetTotalCheckpoints();
+		MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, AllRobots, GS);
 
-		// Build replicated tile overrides (non-Normal tiles only)
-		GS->Rep_TileOverrides.Empty();
-		for (const auto& Pair : GridManagerInstance->GridMap)
-		{
-			if (Pair.Value.TileType != ETileType::Normal)
-			{
-				FReplicatedTileEntry Entry;
-				Entry.X = Pair.Key.X;
-				Entry.Y = Pair.Key.Y;
-				Entry.TileType = Pair.Value.TileType;
-				Entry.CheckpointNumber = Pair.Value.CheckpointNumber;
-				GS->Rep_TileOverrides.Add(Entry);
-			}
-		}
+		// Board tiles and walls; later edits replicate as fast-array deltas
+		GS->SetReplicatedGrid(GridManagerInstance);
 	}
 
 	FString Message = FString::Printf(TEXT("%d Robots ready. "), Robots.Num());
@@ -5,6 +5,10 @@
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
 #include "RobotMovementComponent.h"
+#include "RallySimulator.h"
+#include "RallyReplay.h"
+#include "RallyGameEvent.h"
+#include "Tasks/Pipe.h"
 #include "RobotRallyGameMode.generated.h"
 
 class AGridManager;
@@ -13,6 +17,7 @@ class ARobotRallyHUD;
 class AController;
 class ARobotAIController;
 class ARobotRallyPlayerState;
+struct FRallyPlanningSnapshot;
 
 UENUM(BlueprintType)
 enum class ECardAction : uint8
@@ -54,28 +59,13 @@ struct FRobotProgram
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	TArray<FRobotCard> CommittedProgram;
-};
-
-USTRUCT(BlueprintType)
-struct FExecutionQueueEntry
-{
-	GENERATED_BODY()
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	ARobotPawn* Robot = nullptr;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	FRobotCard Card;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	int32 RegisterNumber = 0;
 
-	bool operator<(const FExecutionQueueEntry& Other) const
-	{
-		return Card.Priority > Other.Card.Priority;  // Higher priority first
-	}
+	// Bumped whenever HandCards or RegisterSlots change (see SyncPlayerStateHand)
+	uint32 Version = 0;
 };
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnRobotProgramChanged, ARobotPawn* /*Robot*/);
+
 UENUM(BlueprintType)
 enum class EGameState : uint8
 {
@@ -119,8 +109,11 @@ class ROBOTRALLY_API ARobotRallyGameMode : public AGameModeBase
 public:
 	ARobotRallyGameMode();
 
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	// Network lifecycle
@@ -131,8 +124,12 @@ public:
 	void AssignRobotToPlayer(APlayerController* NewPlayer);
 
 	// Copy server-side FRobotProgram hand/registers to the player's PlayerState for replication
+	// and notify local listeners (OnProgramChanged, PlayerState::OnCardsChanged)
 	void SyncPlayerStateHand(ARobotPawn* Robot);
 
+	// A robot's hand or registers changed; lets the standalone HUD update without polling
+	FOnRobotProgramChanged OnProgramChanged;
+
 	// Broadcast event message to all clients via GameState multicast RPC
 	void BroadcastEventMessage(const FString& Text, FColor Color = FColor::White);
 
@@ -152,22 +149,44 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game|Setup")
 	TArray<FRobotSpawnData> RobotSpawnConfigs;
 
+	// Seed for every random stream of the match (0 = pick one at match start). URL option ?Seed=N overrides.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game|Setup")
+	int32 MatchSeed = 0;
+
+	// Seed of a stream owned by this match; the same MatchSeed and Salt always give the same seed
+	static int32 DeriveStreamSeed(int32 InMatchSeed, uint32 Salt);
+
+	// Random stream for board hazards
+	FRandomStream& GetHazardStream() { return HazardStream; }
+
+	// Record the match to Saved/Replays (rewritten in the background after each round). URL option ?RecordReplay
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game|Replay")
+	bool bRecordReplays = false;
+
+	// Recordings kept in Saved/Replays; the oldest are deleted when a new one starts (0 = keep all)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game|Replay", meta = (ClampMin = "0"))
+	int32 MaxKeptReplays = 20;
+
+	// Replay file to watch instead of a live match. URL option ?Replay=<file>
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game|Replay")
+	FString ReplayToPlay;
+
+	// Playback speed multiplier (global time dilation). URL option ?ReplaySpeed=N
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game|Replay", meta = (ClampMin = "0.1"))
+	float ReplaySpeed = 1.0f;
+
+	bool IsPlayingReplay() const { return ReplayPlayback.IsValid(); }
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Game|Robots")
 	TArray<ARobotPawn*> Robots;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Game|Cards")
 	TArray<FRobotProgram> RobotPrograms;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Game|Execution")
-	TArray<FExecutionQueueEntry> ExecutionQueue;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Game|Execution")
-	int32 CurrentExecutionIndex = 0;
-
 	UPROPERTY()
 	TSet<ARobotPawn*> MovingRobots;
 
-	static constexpr int32 NUM_REGISTERS = 5;
+	static constexpr int32 NUM_REGISTERS = FRallySimulator::NUM_REGISTERS;
 	static constexpr int32 DECK_SIZE = 84;
 	static constexpr int32 BASE_HAND_SIZE = 9;
 	static constexpr int32 MIN_HAND_SIZE = 5;
@@ -188,8 +207,17 @@ public:
 
 	bool IsCardInRegister(const FRobotProgram* Program, int32 HandIndex) const;
 
+	// Set all registers of Robot at once (hand index per register, -1 = empty).
+	// Validated as a whole; nothing changes and OutError is set if any slot is invalid.
+	bool SubmitProgram(ARobotPawn* Robot, TConstArrayView<int32> HandIndices, FString& OutError);
+
 	static FString GetCardActionName(ECardAction Action);
 
+	// Rules shared with headless simulation (URobotRallySimCommandlet)
+	static void BuildStandardDeck(TArray<FRobotCard>& OutDeck);
+	static void ShuffleCards(TArray<FRobotCard>& Cards, FRandomStream& Stream);
+	static int32 GetHandSize(int32 Health, int32 MaxHealth);
+
 	// Tile hazard processing (public so RobotPawn can trigger after manual moves)
 	UFUNCTION(BlueprintCallable, Category = "Game")
 	void ProcessTileEffects();
@@ -197,19 +225,44 @@ public:
 	// True while tile effects/conveyors are being processed (prevents re-triggering)
 	bool bProcessingTileEffects = false;
 
-	// Called by RobotPawn after WASD input to start polling for movement completion
-	void StartManualMoveTick();
+	// Called after WASD input; processes tile effects once every robot has settled
+	void WaitForManualMove();
+
+	// Pause between registers while replaying a round (0 = continue immediately)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game|Execution", meta = (ClampMin = "0.0"))
+	float RegisterPauseSeconds = 0.3f;
 
 	// Push a message to the on-screen event log
 	void ShowEventMessage(const FString& Text, FColor Color = FColor::White);
 
+	// Typed event-log entry. Standalone shows it immediately; on a server it is queued
+	// and sent to clients in one batch per register (formatted client-side).
+	void PostGameEvent(ERallyGameEventType Type, int32 RobotIndex, int32 A = 0, int32 B = 0, int32 C = 0);
+
+	// Send queued game events now
+	void FlushGameEvents();
+
 	// AI controller ready tracking - public so controllers can signal when ready
 	UFUNCTION(BlueprintCallable, Category = "Game")
 	void OnControllerReady(AController* Controller);
 
+	// Snapshot of the current board, robots and committed programs for the rules simulator
+	FRallySimulator CreateSimulator() const;
+
+	// Thread-safe board snapshot for AI planning, taken once per programming phase
+	TSharedRef<const FRallyPlanningSnapshot> GetPlanningSnapshot();
+
+	// Occupancy index: living robot at (X, Y) other than IgnoreRobot, or nullptr. O(1) for unstacked tiles.
+	ARobotPawn* FindRobotAt(int32 X, int32 Y, const ARobotPawn* IgnoreRobot = nullptr) const;
+
+	// Called by ARobotPawn whenever its grid position changes
+	void NotifyRobotMoved(ARobotPawn* Robot, FIntVector From);
+
 private:
 	void SetupTestScene();
-	void ExecuteCardAction(ARobotPawn* Robot, ECardAction Action);
+
+	// Resolve MatchSeed, seed the match streams and record the seed in GameState
+	void InitMatchRandomStreams();
 
 	void BuildDeck();
 	void ShuffleDeck();
@@ -217,26 +270,74 @@ private:
 	void CommitAllRobotPrograms();
 	void DiscardHand();
 
-	void BuildExecutionQueue(int32 RegisterIndex);
-	void ProcessExecutionQueue();
-	void CheckParallelMovementComplete();
-	void ProcessAllRobotTileEffects();
-	void ProcessRobotTileEffects(ARobotPawn* Robot);
-	void ProcessAllConveyors();
-	void ProcessRobotConveyors(ARobotPawn* Robot);
-	void CheckWinLoseConditions();
-	void OnTileEffectsComplete();
+	// Switch to Executing and clear the previous round's events
+	void EnterExecutionState();
+
+	// Event replay: the simulator resolves the round up front, actors only animate the result
+	void ReplayNextStep();
+	void ApplyReplayEvent(const FRallyEvent& Event);
+	void OnReplayFinished();
+	bool PruneSettledRobots();
+	void EnterGameOver();
+	static bool IsReplayBarrier(ERallyEventType Type);
+
+	// Match recording: started on the first round, saved after every round
+	void RecordReplayRound(const FRallySimulator& Sim);
+	TUniquePtr<FRallyReplay> ReplayRecording;
+	FString ReplayRecordingPath;
+
+	// Background writes of ReplayRecordingPath, run one at a time in order
+	UE::Tasks::FPipe ReplayWritePipe{ UE_SOURCE_LOCATION };
+
+	// Match playback: ReplayToPlay drives the rounds instead of cards and controllers
+	bool LoadReplayToPlay();
+	bool ApplyReplayBoard();
+	void PlayNextReplayRound();
+	TUniquePtr<FRallyReplay> ReplayPlayback;
+	TUniquePtr<FRallySimulator> PlaybackSim;
+	int32 PlaybackRound = 0;
+
+	// Per-match random streams; AI controllers own theirs (see DeriveStreamSeed)
+	FRandomStream DeckStream;
+	FRandomStream HazardStream;
 
 	// AI controller tracking
 	TSet<AController*> ReadyControllers;
+
+	// Shared by every AI planning task of the current programming phase
+	TSharedPtr<const FRallyPlanningSnapshot> PlanningSnapshot;
+
+	// Typed event-log entries waiting for the next flush
+	TArray<FRallyGameEvent> PendingGameEvents;
+
 	bool AreAllRobotsReady() const;
 	void SpawnRobotsWithControllers();
 	TSubclassOf<AController> GetControllerClassForType(ERobotControllerType Type);
 
+	// Bound to every robot's URobotMovementComponent::OnMovementFinished
+	UFUNCTION()
+	void OnRobotMovementFinished(URobotMovementComponent* MovementComponent);
+
 	int32 CurrentRegister = 0;
-	FTimerHandle MovementCheckTimerHandle;
-	FTimerHandle TileEffectTimerHandle;
-	FTimerHandle ManualMoveTimerHandle;
+	FTimerHandle RegisterDelayTimerHandle;
+
+	// Replay is parked at a barrier until MovingRobots drains
+	bool bWaitingForMovement = false;
+
+	// WASD move in flight; tile effects run once it settles
+	bool bWaitingForManualMove = false;
+
+	// One entry per tile (X + Y * Width); may hold any one of several stacked robots
+	UPROPERTY()
+	TArray<ARobotPawn*> RobotOccupancy;
+
+	void RebuildOccupancy();
+
+	// Network: robots only replicate while a round executes (dormant while programming)
+	void SetRobotsNetDormant(bool bDormant);
+	ARobotPawn* FindRobotAtSlow(int32 X, int32 Y, const ARobotPawn* IgnoreRobot) const;
 
-	void CheckManualMoveComplete();
+	// Resolved events of the round (or manual move) being replayed
+	TArray<FRallyEvent> RoundEvents;
+	int32 ReplayIndex = 0;
 };
@@ -2,35 +2,365 @@
 
 #include "RobotRallyGameState.h"
 #include "RobotRallyHUD.h"
+#include "RobotController.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "GameFramework/PlayerController.h"
 #include "Engine/World.h"
+#include "TimerManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// FReplicatedTileEntry / FReplicatedTileArray
+
+FPackedTile FReplicatedTileEntry::ToPackedTile() const
+{
+	FPackedTile Tile;
+	Tile.TileType = TileType;
+	Tile.Walls = Walls;
+	Tile.CheckpointNumber = CheckpointNumber;
+	return Tile;
+}
+
+void FReplicatedTileEntry::PostReplicatedAdd(const FReplicatedTileArray& InArraySerializer)
+{
+	if (InArraySerializer.OwnerState)
+	{
+		InArraySerializer.OwnerState->ApplyReplicatedTile(*this, false);
+	}
+}
+
+void FReplicatedTileEntry::PostReplicatedChange(const FReplicatedTileArray& InArraySerializer)
+{
+	if (InArraySerializer.OwnerState)
+	{
+		InArraySerializer.OwnerState->ApplyReplicatedTile(*this, false);
+	}
+}
+
+void FReplicatedTileEntry::PreReplicatedRemove(const FReplicatedTileArray& InArraySerializer)
+{
+	if (InArraySerializer.OwnerState)
+	{
+		InArraySerializer.OwnerState->ApplyReplicatedTile(*this, true);
+	}
+}
+
+void FReplicatedTileArray::SetTile(int32 TileIndex, const FPackedTile& Tile, const FPackedTile& BaseTile)
+{
+	// FTileGrid::Init keeps every board within 16-bit indices
+	if (!ensureMsgf(TileIndex >= 0 && TileIndex < FTileGrid::MaxTiles, TEXT("Tile index %d does not fit the replicated entry"), TileIndex))
+	{
+		return;
+	}
+
+	const bool bDefault = Tile == BaseTile;
+
+	// Boards hold at most a few hundred entries; edits are rare
+	const int32 ItemIndex = Items.IndexOfByPredicate([TileIndex](const FReplicatedTileEntry& Entry)
+	{
+		return Entry.TileIndex == TileIndex;
+	});
+
+	if (ItemIndex == INDEX_NONE)
+	{
+		if (bDefault) return;
+
+		FReplicatedTileEntry& Entry = Items.AddDefaulted_GetRef();
+		Entry.TileIndex = static_cast<uint16>(TileIndex);
+		Entry.TileType = Tile.TileType;
+		Entry.Walls = Tile.Walls;
+		Entry.CheckpointNumber = Tile.CheckpointNumber;
+		MarkItemDirty(Entry);
+		return;
+	}
+
+	if (bDefault)
+	{
+		Items.RemoveAtSwap(ItemIndex);
+		MarkArrayDirty();
+		return;
+	}
+
+	FReplicatedTileEntry& Entry = Items[ItemIndex];
+	if (Entry.TileType == Tile.TileType && Entry.Walls == Tile.Walls && Entry.CheckpointNumber == Tile.CheckpointNumber)
+	{
+		return;
+	}
+	Entry.TileType = Tile.TileType;
+	Entry.Walls = Tile.Walls;
+	Entry.CheckpointNumber = Tile.CheckpointNumber;
+	MarkItemDirty(Entry);
+}
+
+void FReplicatedTileArray::Clear()
+{
+	Items.Reset();
+	MarkArrayDirty();
+}
+
+// ARobotRallyGameState
 
 ARobotRallyGameState::ARobotRallyGameState()
 {
 	bReplicates = true;
 	bAlwaysRelevant = true;
+	Rep_TileOverrides.OwnerState = this;
 }
 
 void ARobotRallyGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(ARobotRallyGameState, Rep_CurrentGameState);
-	DOREPLIFETIME(ARobotRallyGameState, Rep_CurrentRegister);
-	DOREPLIFETIME(ARobotRallyGameState, AllRobots);
-	DOREPLIFETIME(ARobotRallyGameState, Rep_GridWidth);
-	DOREPLIFETIME(ARobotRallyGameState, Rep_GridHeight);
-	DOREPLIFETIME(ARobotRallyGameState, Rep_TileOverrides);
-	DOREPLIFETIME(ARobotRallyGameState, Rep_TotalCheckpoints);
+	// Push model: only compared after being marked dirty where they change
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyGameState, Rep_CurrentGameState, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyGameState, Rep_CurrentRegister, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyGameState, Rep_MatchSeed, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyGameState, AllRobots, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyGameState, Rep_GridWidth, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyGameState, Rep_GridHeight, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyGameState, Rep_BoardHash, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyGameState, Rep_TileOverrides, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyGameState, Rep_TotalCheckpoints, Params);
 }
 
 void ARobotRallyGameState::OnRep_CurrentGameState()
 {
 	UE_LOG(LogTemp, Log, TEXT("GameState replicated: %d"), (int32)Rep_CurrentGameState);
+	OnGameStateChanged.Broadcast(Rep_CurrentGameState);
+}
+
+void ARobotRallyGameState::SetCurrentGameState(EGameState NewState)
+{
+	Rep_CurrentGameState = NewState;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, Rep_CurrentGameState, this);
+	OnGameStateChanged.Broadcast(NewState);
+}
+
+void ARobotRallyGameState::SetReplicatedGrid(AGridManager* Grid)
+{
+	if (!HasAuthority() || !Grid) return;
+
+	if (ReplicatedGrid)
+	{
+		ReplicatedGrid->OnTileChanged.RemoveAll(this);
+	}
+	ReplicatedGrid = Grid;
+
+	Rep_GridWidth = Grid->Width;
+	Rep_GridHeight = Grid->Height;
+	Rep_TotalCheckpoints = Grid->GetTotalCheckpoints();
+
+	// The current board becomes the base; only later edits go into the fast array
+	Grid->GetTileGrid().WriteBoardBlob(BoardBlob);
+	Rep_BoardHash = FTileGrid::HashBoardBlob(BoardBlob);
+	SetBaseBoard(BoardBlob, Rep_BoardHash);
+	Rep_TileOverrides.Clear();
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, Rep_GridWidth, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, Rep_GridHeight, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, Rep_TotalCheckpoints, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, Rep_BoardHash, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, Rep_TileOverrides, this);
+
+	Grid->OnTileChanged.AddUObject(this, &ARobotRallyGameState::OnGridTileChanged);
+}
+
+void ARobotRallyGameState::OnGridTileChanged(int32 TileIndex)
+{
+	if (!ReplicatedGrid) return;
+
+	const FTileGrid& Grid = ReplicatedGrid->GetTileGrid();
+	if (!Grid.Tiles.IsValidIndex(TileIndex)) return;
+
+	const FPackedTile BaseTile = BaseTiles.IsValidIndex(TileIndex) ? BaseTiles[TileIndex] : FPackedTile();
+	Rep_TileOverrides.SetTile(TileIndex, Grid.Tiles[TileIndex], BaseTile);
+	Rep_TotalCheckpoints = Grid.NumCheckpoints;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, Rep_TileOverrides, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ARobotRallyGameState, Rep_TotalCheckpoints, this);
+}
+
+bool ARobotRallyGameState::SetBaseBoard(TConstArrayView<uint8> Blob, uint64 Hash)
+{
+	if (!FTileGrid::ReadBoardBlob(Blob, BaseWidth, BaseHeight, BaseTiles))
+	{
+		BaseTiles.Reset();
+		BaseBoardHash = 0;
+		return false;
+	}
+	BaseBoardHash = Hash;
+	return true;
+}
+
+FString ARobotRallyGameState::GetBoardCachePath(uint64 Hash)
+{
+	return FPaths::ProjectSavedDir() / TEXT("BoardCache") / FString::Printf(TEXT("%016llx.board"), Hash);
+}
+
+void ARobotRallyGameState::OnRep_BoardHash()
+{
+	if (Rep_BoardHash == 0 || BaseBoardHash == Rep_BoardHash) return;
+
+	bBoardRequested = false;
+	PendingBoardBlob.Reset();
+	GetWorldTimerManager().ClearTimer(BoardRequestTimerHandle);
+	if (LoadCachedBoard())
+	{
+		UE_LOG(LogTemp, Log, TEXT("Board %016llx loaded from cache"), Rep_BoardHash);
+		ApplyReplicatedTiles(nullptr);
+		return;
+	}
+	RequestBoardIfNeeded();
+}
+
+bool ARobotRallyGameState::LoadCachedBoard()
+{
+	TArray<uint8> Blob;
+	if (!FFileHelper::LoadFileToArray(Blob, *GetBoardCachePath(Rep_BoardHash), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	// A damaged or stale file is ignored and replaced by the server's copy
+	if (FTileGrid::HashBoardBlob(Blob) != Rep_BoardHash) return false;
+
+	return SetBaseBoard(Blob, Rep_BoardHash);
+}
+
+void ARobotRallyGameState::RequestBoardIfNeeded()
+{
+	if (HasAuthority() || Rep_BoardHash == 0 || BaseBoardHash == Rep_BoardHash || bBoardRequested) return;
+
+	ARobotController* PC = Cast<ARobotController>(GetWorld()->GetFirstPlayerController());
+	if (!PC) return;  // Retried from the controller's BeginPlay
+
+	UE_LOG(LogTemp, Log, TEXT("Board %016llx not cached, requesting it from the server"), Rep_BoardHash);
+	PendingBoardBlob.Reset();
+	PC->RequestBoard(0);
+	bBoardRequested = true;
+	GetWorldTimerManager().SetTimer(BoardRequestTimerHandle, this,
+		&ARobotRallyGameState::OnBoardRequestTimeout, BOARD_REQUEST_TIMEOUT);
+}
+
+void ARobotRallyGameState::OnBoardRequestTimeout()
+{
+	UE_LOG(LogTemp, Warning, TEXT("Board %016llx request timed out after %d bytes, retrying"),
+		Rep_BoardHash, PendingBoardBlob.Num());
+	bBoardRequested = false;
+	PendingBoardBlob.Reset();
+	RequestBoardIfNeeded();
+}
+
+void ARobotRallyGameState::ReceiveBoardChunk(uint64 Hash, int32 Offset, int32 TotalSize, const TArray<uint8>& Chunk)
+{
+	// Chunks of an older board or an abandoned request are dropped; the timeout retries
+	if (!bBoardRequested || Hash != Rep_BoardHash || Offset != PendingBoardBlob.Num()) return;
+
+	const int32 MaxBlobSize = 4 + 3 * FTileGrid::MaxTiles;
+	if (TotalSize > MaxBlobSize || Chunk.Num() == 0 || Offset + Chunk.Num() > TotalSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Malformed board chunk at %d of %d bytes"), Offset, TotalSize);
+		return;
+	}
+
+	PendingBoardBlob.Append(Chunk);
+	if (PendingBoardBlob.Num() < TotalSize)
+	{
+		// Still making progress: restart the timeout and ask for the next chunk
+		GetWorldTimerManager().SetTimer(BoardRequestTimerHandle, this,
+			&ARobotRallyGameState::OnBoardRequestTimeout, BOARD_REQUEST_TIMEOUT);
+		if (ARobotController* PC = Cast<ARobotController>(GetWorld()->GetFirstPlayerController()))
+		{
+			PC->RequestBoard(PendingBoardBlob.Num());
+		}
+		return;
+	}
+
+	const TArray<uint8> Blob = MoveTemp(PendingBoardBlob);
+	PendingBoardBlob.Reset();
+	ReceiveBoardBlob(Blob);
+}
+
+void ARobotRallyGameState::ReceiveBoardBlob(const TArray<uint8>& Blob)
+{
+	bBoardRequested = false;
+	GetWorldTimerManager().ClearTimer(BoardRequestTimerHandle);
+
+	const uint64 Hash = FTileGrid::HashBoardBlob(Blob);
+	if (Hash != Rep_BoardHash || !SetBaseBoard(Blob, Hash))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Received board does not match hash %016llx, requesting it again"), Rep_BoardHash);
+		RequestBoardIfNeeded();
+		return;
+	}
+
+	FFileHelper::SaveArrayToFile(Blob, *GetBoardCachePath(Hash));
+	ApplyReplicatedTiles(nullptr);
+}
+
+void ARobotRallyGameState::ApplyReplicatedTiles(AGridManager* Grid)
+{
+	if (Grid)
+	{
+		ReplicatedGrid = Grid;
+	}
+	else if (!ReplicatedGrid)
+	{
+		ReplicatedGrid = Cast<AGridManager>(
+			UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
+	}
+
+	// Needs both an initialized board and the base it is built on
+	if (!ReplicatedGrid || !ReplicatedGrid->HasActorBegunPlay()) return;
+	if (BaseBoardHash == 0 || BaseBoardHash != Rep_BoardHash) return;
+
+	ReplicatedGrid->ApplyBoard(BaseWidth, BaseHeight, BaseTiles);
+	for (const FReplicatedTileEntry& Entry : Rep_TileOverrides.Items)
+	{
+		ApplyReplicatedTile(Entry, false);
+	}
+}
+
+void ARobotRallyGameState::ApplyReplicatedTile(const FReplicatedTileEntry& Entry, bool bRemoved)
+{
+	if (!ReplicatedGrid)
+	{
+		ReplicatedGrid = Cast<AGridManager>(
+			UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
+	}
+
+	// Tiles arriving before the board or its base is ready are applied by ApplyReplicatedTiles
+	if (!ReplicatedGrid || !ReplicatedGrid->HasActorBegunPlay()) return;
+	if (BaseBoardHash == 0 || BaseBoardHash != Rep_BoardHash) return;
+
+	const FTileGrid& Grid = ReplicatedGrid->GetTileGrid();
+	if (!Grid.Tiles.IsValidIndex(Entry.TileIndex) || !BaseTiles.IsValidIndex(Entry.TileIndex)) return;
+
+	// A removed entry means the tile is back to its base state
+	const FTileData Data = FTileGrid::Unpack(bRemoved ? BaseTiles[Entry.TileIndex] : Entry.ToPackedTile());
+	ReplicatedGrid->SetTileType(Grid.FromIndex(Entry.TileIndex), Data);
 }
 
 void ARobotRallyGameState::MulticastShowEventMessage_Implementation(const FString& Text, FColor Color)
+{
+	AddLocalEventMessage(Text, Color);
+}
+
+void ARobotRallyGameState::MulticastGameEvents_Implementation(const TArray<FRallyGameEvent>& Events)
+{
+	for (const FRallyGameEvent& Event : Events)
+	{
+		FColor Color;
+		const FString Text = Event.ToText(Color);
+		AddLocalEventMessage(Text, Color);
+	}
+}
+
+void ARobotRallyGameState::AddLocalEventMessage(const FString& Text, FColor Color)
 {
 	// On each client, find the local player's HUD and add the message
 	UWorld* World = GetWorld();
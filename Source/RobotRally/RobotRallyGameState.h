@@ -4,29 +4,80 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameStateBase.h"
+#include "Net/Serialization/FastArraySerializer.h"
 #include "GridManager.h"
 #include "RobotRallyGameMode.h"
+#include "RallyGameEvent.h"
 #include "RobotRallyGameState.generated.h"
 
 class ARobotPawn;
+class ARobotRallyGameState;
+struct FReplicatedTileArray;
 
-// Replicated tile entry for non-Normal tiles (avoids TMap replication issues)
-USTRUCT(BlueprintType)
-struct FReplicatedTileEntry
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnRallyGameStateChanged, EGameState /*NewState*/);
+
+// Replicated state of one tile that differs from the board identified by Rep_BoardHash
+USTRUCT()
+struct FReplicatedTileEntry : public FFastArraySerializerItem
 {
 	GENERATED_BODY()
 
+	// FTileGrid index (X + Y * Width); fixed for the lifetime of the entry
 	UPROPERTY()
-	int32 X = 0;
+	uint16 TileIndex = 0;
 
 	UPROPERTY()
-	int32 Y = 0;
+	ETileType TileType = ETileType::Normal;
 
 	UPROPERTY()
-	ETileType TileType = ETileType::Normal;
+	uint8 Walls = 0;
+
+	UPROPERTY()
+	uint8 CheckpointNumber = 0;
+
+	FPackedTile ToPackedTile() const;
+
+	// Client callbacks from the fast array
+	void PostReplicatedAdd(const FReplicatedTileArray& InArraySerializer);
+	void PostReplicatedChange(const FReplicatedTileArray& InArraySerializer);
+	void PreReplicatedRemove(const FReplicatedTileArray& InArraySerializer);
+};
+
+/**
+ * Board edits replicated as a fast array on top of the hashed base board: only entries
+ * that were added, changed or removed since the last update go over the wire.
+ */
+USTRUCT()
+struct FReplicatedTileArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
 
 	UPROPERTY()
-	int32 CheckpointNumber = 0;
+	TArray<FReplicatedTileEntry> Items;
+
+	// Receives the client callbacks
+	UPROPERTY(NotReplicated)
+	ARobotRallyGameState* OwnerState = nullptr;
+
+	// Server: store a tile's state; the entry is removed when it matches BaseTile again
+	void SetTile(int32 TileIndex, const FPackedTile& Tile, const FPackedTile& BaseTile);
+
+	// Server: drop every entry
+	void Clear();
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FReplicatedTileEntry, FReplicatedTileArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FReplicatedTileArray> : public TStructOpsTypeTraitsBase2<FReplicatedTileArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
 };
 
 UCLASS()
@@ -47,6 +98,16 @@ public:
 	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Game")
 	int32 Rep_CurrentRegister = 0;
 
+	// Seed the match was played with; reproduces deck order and AI choices
+	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Game")
+	int32 Rep_MatchSeed = 0;
+
+	// Server: set the replicated game state and notify local listeners
+	void SetCurrentGameState(EGameState NewState);
+
+	// Game state changed (server: in SetCurrentGameState, client: on replication)
+	FOnRallyGameStateChanged OnGameStateChanged;
+
 	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Game")
 	TArray<ARobotPawn*> AllRobots;
 
@@ -58,18 +119,89 @@ public:
 	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Grid")
 	int32 Rep_GridHeight = 10;
 
-	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Grid")
-	TArray<FReplicatedTileEntry> Rep_TileOverrides;
+	// Content hash of the base board. Clients load it from their board cache or fetch it once.
+	UPROPERTY(ReplicatedUsing = OnRep_BoardHash)
+	uint64 Rep_BoardHash = 0;
+
+	// Tiles and walls changed since the base board was published
+	UPROPERTY(Replicated)
+	FReplicatedTileArray Rep_TileOverrides;
 
 	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Grid")
 	int32 Rep_TotalCheckpoints = 0;
 
+	// Server: publish Grid's board and keep replicating its edits
+	void SetReplicatedGrid(AGridManager* Grid);
+
+	// Client: write the base board and every replicated tile into Grid (used once Grid has initialized)
+	void ApplyReplicatedTiles(AGridManager* Grid);
+
+	// Server: base board blob sent to clients without a cached copy
+	const TArray<uint8>& GetBoardBlob() const { return BoardBlob; }
+
+	// Client: one chunk of the base board from the server; the next one is requested until it is complete
+	void ReceiveBoardChunk(uint64 Hash, int32 Offset, int32 TotalSize, const TArray<uint8>& Chunk);
+
+	// Client: ask the server for the base board if it is neither loaded nor requested yet
+	void RequestBoardIfNeeded();
+
+	// Client: seconds without a chunk before a board request is given up and retried
+	static constexpr float BOARD_REQUEST_TIMEOUT = 10.0f;
+
+	// Client: write one replicated tile into the local GridManager
+	void ApplyReplicatedTile(const FReplicatedTileEntry& Entry, bool bRemoved);
+
 	// --- Multicast event messages ---
 
 	UFUNCTION(NetMulticast, Unreliable)
 	void MulticastShowEventMessage(const FString& Text, FColor Color);
 
+	// Batch of typed event-log entries; each client formats its own text
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastGameEvents(const TArray<FRallyGameEvent>& Events);
+
 private:
 	UFUNCTION()
 	void OnRep_CurrentGameState();
+
+	UFUNCTION()
+	void OnRep_BoardHash();
+
+	// Decode Blob as the base board; false if it is malformed
+	bool SetBaseBoard(TConstArrayView<uint8> Blob, uint64 Hash);
+
+	// Client: load the base board for Rep_BoardHash from the local cache
+	bool LoadCachedBoard();
+
+	static FString GetBoardCachePath(uint64 Hash);
+
+	// Client: complete base board received from the server; cached on disk by hash
+	void ReceiveBoardBlob(const TArray<uint8>& Blob);
+
+	// Client: the server stopped answering a board request
+	void OnBoardRequestTimeout();
+
+	// Add a line to the event log of every local player's HUD
+	void AddLocalEventMessage(const FString& Text, FColor Color);
+
+	// Server: mirror a GridManager edit into Rep_TileOverrides
+	void OnGridTileChanged(int32 TileIndex);
+
+	// Server: board being replicated; client: local board receiving tiles
+	UPROPERTY()
+	AGridManager* ReplicatedGrid = nullptr;
+
+	// Server: encoded base board
+	TArray<uint8> BoardBlob;
+
+	// Decoded base board and the hash it was loaded for
+	TArray<FPackedTile> BaseTiles;
+	int32 BaseWidth = 0;
+	int32 BaseHeight = 0;
+	uint64 BaseBoardHash = 0;
+
+	// Client: a board request is in flight, the chunks received so far and its timeout
+	bool bBoardRequested = false;
+	TArray<uint8> PendingBoardBlob;
+	FTimerHandle BoardRequestTimerHandle;
 };
@@ -5,6 +5,7 @@
 #include "RobotRallyGameMode.h"
 #include "RobotRallyGameState.h"
 #include "RobotRallyPlayerState.h"
+#include "GridManager.h"
 #include "UI/RobotRallyMainWidget.h"
 #include "UI/ProgrammingDeckWidget.h"
 #include "Engine/Canvas.h"
@@ -51,9 +52,10 @@ void ARobotRallyHUD::DrawHUD()
 {
 	Super::DrawHUD();
 
-	// Update widget data each frame (polls from PlayerState or GameMode)
+	// Widgets only update when a bound data source reported a change
 	if (bUseUMGWidgets)
 	{
+		RefreshDataBindings();
 		UpdateWidgetData();
 	}
 
@@ -71,19 +73,20 @@ void ARobotRallyHUD::DrawHUD()
 	const float Padding = 10.0f;
 
 	// --- Event log (bottom-left) ---
-	// Tick message timers and remove expired
-	for (int32 i = Messages.Num() - 1; i >= 0; --i)
+	// Tick message timers; every message lives MESSAGE_DURATION, so they expire oldest first
+	for (int32 i = 0; i < MessageCount; ++i)
 	{
-		Messages[i].TimeRemaining -= DeltaTime;
-		if (Messages[i].TimeRemaining <= 0.0f)
-		{
-			Messages.RemoveAt(i);
-		}
+		GetMessage(i).TimeRemaining -= DeltaTime;
+	}
+	while (MessageCount > 0 && GetMessage(0).TimeRemaining <= 0.0f)
+	{
+		MessageHead = (MessageHead + 1) % MAX_MESSAGES;
+		--MessageCount;
 	}
 
-	if (Messages.Num() > 0)
+	if (MessageCount > 0)
 	{
-		float LogHeight = Messages.Num() * LineHeight + Padding * 2.0f;
+		float LogHeight = MessageCount * LineHeight + Padding * 2.0f;
 		float LogY = Canvas->SizeY - LogHeight - 40.0f;
 		float LogX = Padding;
 		float LogWidth = 450.0f;
@@ -97,16 +100,17 @@ void ARobotRallyHUD::DrawHUD()
 		Canvas->DrawItem(BG);
 
 		// Draw messages (oldest at top, newest at bottom)
-		for (int32 i = 0; i < Messages.Num(); ++i)
+		for (int32 i = 0; i < MessageCount; ++i)
 		{
-			float Alpha = FMath::Clamp(Messages[i].TimeRemaining / 1.0f, 0.3f, 1.0f);
-			FLinearColor DrawColor(Messages[i].Color);
+			const FEventMessage& Message = GetMessage(i);
+			float Alpha = FMath::Clamp(Message.TimeRemaining / 1.0f, 0.3f, 1.0f);
+			FLinearColor DrawColor(Message.Color);
 			DrawColor.A = Alpha;
 
 			float TextY = LogY + Padding + i * LineHeight;
 			FCanvasTextItem TextItem(
 				FVector2D(LogX + Padding, TextY),
-				FText::FromString(Messages[i].Text),
+				FText::FromString(Message.Text),
 				Font, DrawColor);
 			TextItem.EnableShadow(FLinearColor::Black);
 			Canvas->DrawItem(TextItem);
@@ -243,7 +247,7 @@ void ARobotRallyHUD::DrawCardSelection()
 		if (!PS || PS->Rep_HandCards.Num() == 0) return;
 
 		HandCards = PS->Rep_HandCards;
-		RegisterSlots = PS->Rep_RegisterSlots;
+		RegisterSlots = PS->GetDisplayedRegisterSlots();
 
 		// Get robot index from GameState
 		ARobotRallyGameState* GS = GetRobotRallyGameState();
@@ -436,6 +440,131 @@ void ARobotRallyHUD::DrawNetworkDebug()
 	Canvas->DrawItem(DebugItem);
 }
 
+ARobotPawn* ARobotRallyHUD::GetDisplayedRobot() const
+{
+	if (GetWorld()->GetNetMode() != NM_Standalone)
+	{
+		ARobotRallyPlayerState* PS = GetLocalPlayerState();
+		return PS ? PS->Rep_Robot : nullptr;
+	}
+
+	ARobotRallyGameMode* GM = Cast<ARobotRallyGameMode>(GetWorld()->GetAuthGameMode());
+	return (GM && GM->RobotPrograms.Num() > 0) ? GM->RobotPrograms[0].Robot : nullptr;
+}
+
+void ARobotRallyHUD::RefreshDataBindings()
+{
+	// Pointer compares only; sources appear late on clients (PlayerState, Rep_Robot)
+	bool bIsNetwork = (GetWorld()->GetNetMode() != NM_Standalone);
+
+	ARobotRallyPlayerState* PS = bIsNetwork ? GetLocalPlayerState() : nullptr;
+	if (PS != BoundPlayerState.Get())
+	{
+		if (ARobotRallyPlayerState* Old = BoundPlayerState.Get())
+		{
+			Old->OnCardsChanged.RemoveAll(this);
+		}
+		if (PS)
+		{
+			PS->OnCardsChanged.AddUObject(this, &ARobotRallyHUD::HandleCardsChanged);
+		}
+		BoundPlayerState = PS;
+		AppliedDeckVersion = MAX_uint32;
+		bDeckDirty = true;
+	}
+
+	ARobotRallyGameMode* GM = bIsNetwork ? nullptr : Cast<ARobotRallyGameMode>(GetWorld()->GetAuthGameMode());
+	if (GM != BoundGameMode.Get())
+	{
+		if (ARobotRallyGameMode* Old = BoundGameMode.Get())
+		{
+			Old->OnProgramChanged.RemoveAll(this);
+		}
+		if (GM)
+		{
+			GM->OnProgramChanged.AddUObject(this, &ARobotRallyHUD::HandleProgramChanged);
+		}
+		BoundGameMode = GM;
+		AppliedDeckVersion = MAX_uint32;
+		bDeckDirty = true;
+	}
+
+	ARobotPawn* Robot = GetDisplayedRobot();
+	if (Robot != BoundRobot.Get())
+	{
+		if (ARobotPawn* Old = BoundRobot.Get())
+		{
+			Old->OnStatusChanged.RemoveAll(this);
+		}
+		if (Robot)
+		{
+			Robot->OnStatusChanged.AddUObject(this, &ARobotRallyHUD::HandleStatusChanged);
+		}
+		BoundRobot = Robot;
+		AppliedStatusVersion = MAX_uint32;
+		bStatusDirty = true;
+	}
+
+	ARobotRallyGameState* GS = GetRobotRallyGameState();
+	if (GS != BoundGameState.Get())
+	{
+		if (ARobotRallyGameState* Old = BoundGameState.Get())
+		{
+			Old->OnGameStateChanged.RemoveAll(this);
+		}
+		if (GS)
+		{
+			GS->OnGameStateChanged.AddUObject(this, &ARobotRallyHUD::HandleGameStateChanged);
+		}
+		BoundGameState = GS;
+		bGameStateDirty = true;
+	}
+
+	// The total arrives with the board (late on clients)
+	if (GetTotalCheckpoints() != AppliedTotalCheckpoints)
+	{
+		bStatusDirty = true;
+	}
+}
+
+int32 ARobotRallyHUD::GetTotalCheckpoints() const
+{
+	// Standalone reads the GameMode's board, network the replicated GameState
+	if (ARobotRallyGameMode* GM = BoundGameMode.Get())
+	{
+		return GM->GridManagerInstance ? GM->GridManagerInstance->GetTotalCheckpoints() : 0;
+	}
+	if (ARobotRallyGameState* GS = BoundGameState.Get())
+	{
+		return GS->Rep_TotalCheckpoints;
+	}
+	return 0;
+}
+
+void ARobotRallyHUD::HandleCardsChanged()
+{
+	bDeckDirty = true;
+}
+
+void ARobotRallyHUD::HandleProgramChanged(ARobotPawn* Robot)
+{
+	// Standalone shows robot 0's program only
+	if (Robot == GetDisplayedRobot())
+	{
+		bDeckDirty = true;
+	}
+}
+
+void ARobotRallyHUD::HandleStatusChanged(ARobotPawn* Robot)
+{
+	bStatusDirty = true;
+}
+
+void ARobotRallyHUD::HandleGameStateChanged(EGameState NewState)
+{
+	bGameStateDirty = true;
+}
+
 void ARobotRallyHUD::UpdateWidgetData()
 {
 	if (!MainWidget)
@@ -444,18 +573,20 @@ void ARobotRallyHUD::UpdateWidgetData()
 	}
 
 	// Update programming deck if it exists
-	if (MainWidget->ProgrammingDeck)
+	if (bDeckDirty && MainWidget->ProgrammingDeck)
 	{
 		UpdateProgrammingDeckData();
 	}
 
 	// Update other HUD elements
-	UpdateHealthAndStatusData();
+	if (bStatusDirty)
+	{
+		UpdateHealthAndStatusData();
+	}
 
-	// Override visibility if debug flag is set
-	if (bAlwaysShowDeck && MainWidget->ProgrammingDeck)
+	if (bGameStateDirty)
 	{
-		MainWidget->SetProgrammingDeckVisible(true);
+		UpdateGameStateData();
 	}
 }
 
@@ -466,30 +597,27 @@ void ARobotRallyHUD::UpdateProgrammingDeckData()
 		return;
 	}
 
-	bool bIsNetwork = (GetWorld()->GetNetMode() != NM_Standalone);
+	bDeckDirty = false;
 
-	if (bIsNetwork)
+	if (ARobotRallyPlayerState* PS = BoundPlayerState.Get())
 	{
 		// Network mode: Read from PlayerState (replicated data)
-		ARobotRallyPlayerState* PS = GetLocalPlayerState();
-		if (PS)
-		{
-			MainWidget->ProgrammingDeck->UpdateHandCards(PS->Rep_HandCards);
-			MainWidget->ProgrammingDeck->UpdateRegisterSlots(PS->Rep_RegisterSlots);
-		}
+		if (PS->GetCardsVersion() == AppliedDeckVersion) return;
+		AppliedDeckVersion = PS->GetCardsVersion();
+
+		MainWidget->ProgrammingDeck->UpdateDeck(PS->Rep_HandCards, PS->GetDisplayedRegisterSlots());
 	}
-	else
+	else if (ARobotRallyGameMode* GM = BoundGameMode.Get())
 	{
 		// Standalone mode: Read from GameMode (authoritative data)
-		ARobotRallyGameMode* GM = Cast<ARobotRallyGameMode>(GetWorld()->GetAuthGameMode());
-		if (GM && GM->RobotPrograms.Num() > 0)
-		{
-			// Get player's robot program (first robot in standalone)
-			FRobotProgram& PlayerProgram = GM->RobotPrograms[0];
+		if (GM->RobotPrograms.Num() == 0) return;
 
-			MainWidget->ProgrammingDeck->UpdateHandCards(PlayerProgram.HandCards);
-			MainWidget->ProgrammingDeck->UpdateRegisterSlots(PlayerProgram.RegisterSlots);
-		}
+		// Get player's robot program (first robot in standalone)
+		FRobotProgram& PlayerProgram = GM->RobotPrograms[0];
+		if (PlayerProgram.Version == AppliedDeckVersion) return;
+		AppliedDeckVersion = PlayerProgram.Version;
+
+		MainWidget->ProgrammingDeck->UpdateDeck(PlayerProgram.HandCards, PlayerProgram.RegisterSlots);
 	}
 }
 
@@ -500,65 +628,69 @@ void ARobotRallyHUD::UpdateHealthAndStatusData()
 		return;
 	}
 
-	bool bIsNetwork = (GetWorld()->GetNetMode() != NM_Standalone);
+	bStatusDirty = false;
 
-	if (bIsNetwork)
+	// Update health, lives, checkpoints from Robot
+	ARobotPawn* Robot = BoundRobot.Get();
+	const int32 TotalCheckpoints = GetTotalCheckpoints();
+	if (!Robot || (Robot->GetStatusVersion() == AppliedStatusVersion && TotalCheckpoints == AppliedTotalCheckpoints)) return;
+	AppliedStatusVersion = Robot->GetStatusVersion();
+	AppliedTotalCheckpoints = TotalCheckpoints;
+
+	MainWidget->UpdateHealth(Robot->Health, Robot->MaxHealth);
+	MainWidget->UpdateLives(Robot->Lives);
+	MainWidget->UpdateCheckpoints(Robot->CurrentCheckpoint, TotalCheckpoints);
+}
+
+void ARobotRallyHUD::UpdateGameStateData()
+{
+	if (!MainWidget)
 	{
-		// Network mode: Read from PlayerState
-		ARobotRallyPlayerState* PS = GetLocalPlayerState();
-		if (PS)
-		{
-			// Update health, lives, checkpoints from Robot
-			if (PS->Rep_Robot)
-			{
-				MainWidget->UpdateHealth(PS->Rep_Robot->Health, PS->Rep_Robot->MaxHealth);
-				MainWidget->UpdateLives(PS->Rep_Robot->Lives);
-				MainWidget->UpdateCheckpoints(PS->Rep_Robot->CurrentCheckpoint, 5); // TODO: get total from map
-			}
+		return;
+	}
 
-			// Update game state from GameState
-			ARobotRallyGameState* GS = GetRobotRallyGameState();
-			if (GS)
-			{
-				MainWidget->UpdateGameState(GS->Rep_CurrentGameState);
-			}
-		}
+	bGameStateDirty = false;
+
+	// Standalone reads the GameMode (authoritative), network the replicated GameState
+	if (ARobotRallyGameMode* GM = BoundGameMode.Get())
+	{
+		MainWidget->UpdateGameState(GM->CurrentState);
 	}
-	else
+	else if (ARobotRallyGameState* GS = BoundGameState.Get())
 	{
-		// Standalone mode: Read from GameMode
-		ARobotRallyGameMode* GM = Cast<ARobotRallyGameMode>(GetWorld()->GetAuthGameMode());
-		if (GM && GM->RobotPrograms.Num() > 0)
-		{
-			FRobotProgram& PlayerProgram = GM->RobotPrograms[0];
-
-			// Update health, lives, checkpoints from Robot
-			if (PlayerProgram.Robot)
-			{
-				MainWidget->UpdateHealth(PlayerProgram.Robot->Health, PlayerProgram.Robot->MaxHealth);
-				MainWidget->UpdateLives(PlayerProgram.Robot->Lives);
-				MainWidget->UpdateCheckpoints(PlayerProgram.Robot->CurrentCheckpoint, 5);
-			}
+		MainWidget->UpdateGameState(GS->Rep_CurrentGameState);
+	}
 
-			// Update game state from GameMode (this also controls deck visibility)
-			MainWidget->UpdateGameState(GM->CurrentState);
-		}
+	// Override visibility if debug flag is set
+	if (bAlwaysShowDeck && MainWidget->ProgrammingDeck)
+	{
+		MainWidget->SetProgrammingDeckVisible(true);
 	}
 }
 
 void ARobotRallyHUD::AddEventMessage(const FString& Text, FColor Color)
 {
-	FEventMessage Msg;
-	Msg.Text = Text;
-	Msg.Color = Color;
-	Msg.TimeRemaining = MESSAGE_DURATION;
-	Messages.Add(Msg);
+	if (Messages.Num() != MAX_MESSAGES)
+	{
+		Messages.SetNum(MAX_MESSAGES);
+	}
 
-	while (Messages.Num() > MAX_MESSAGES)
+	// Full: overwrite the oldest slot
+	const int32 Slot = (MessageHead + MessageCount) % MAX_MESSAGES;
+	if (MessageCount == MAX_MESSAGES)
+	{
+		MessageHead = (MessageHead + 1) % MAX_MESSAGES;
+	}
+	else
 	{
-		Messages.RemoveAt(0);
+		++MessageCount;
 	}
 
+	FEventMessage& Msg = Messages[Slot];
+	Msg.Text = Text;
+	Msg.Color = Color;
+	Msg.TimeRemaining = MESSAGE_DURATION;
+
 	// Also forward to widget if available
 	if (MainWidget)
 	{
@@ -8,7 +8,10 @@
 
 class ARobotRallyPlayerState;
 class ARobotRallyGameState;
+class ARobotRallyGameMode;
+class ARobotPawn;
 class URobotRallyMainWidget;
+enum class EGameState : uint8;
 
 USTRUCT()
 struct FEventMessage
@@ -57,20 +60,60 @@ private:
 	// Helper: get GameState
 	ARobotRallyGameState* GetRobotRallyGameState() const;
 
-	/** Update widget data from PlayerState (network) or GameMode (standalone) */
+	// Helper: robot shown in the status widgets (PlayerState robot in network, robot 0 standalone)
+	ARobotPawn* GetDisplayedRobot() const;
+
+	// Helper: checkpoints on the board (GridManager standalone, replicated GameState in network)
+	int32 GetTotalCheckpoints() const;
+
+	/** (Re)bind change notifications when the PlayerState, robot or GameState behind the HUD changes */
+	void RefreshDataBindings();
+
+	/** Push data to the widgets that were marked dirty since the last frame */
 	void UpdateWidgetData();
 
 	/** Update programming deck widgets (hand and registers) */
 	void UpdateProgrammingDeckData();
 
-	/** Update health, lives, checkpoints, and game state widgets */
+	/** Update health, lives and checkpoint widgets */
 	void UpdateHealthAndStatusData();
 
+	/** Update game state widget (and deck visibility) */
+	void UpdateGameStateData();
+
+	// Change notification handlers
+	void HandleCardsChanged();
+	void HandleProgramChanged(ARobotPawn* Robot);
+	void HandleStatusChanged(ARobotPawn* Robot);
+	void HandleGameStateChanged(EGameState NewState);
+
+	// Data sources currently bound
+	TWeakObjectPtr<ARobotRallyPlayerState> BoundPlayerState;
+	TWeakObjectPtr<ARobotRallyGameMode> BoundGameMode;
+	TWeakObjectPtr<ARobotPawn> BoundRobot;
+	TWeakObjectPtr<ARobotRallyGameState> BoundGameState;
+
+	// Set by the handlers, cleared once the widgets are updated
+	bool bDeckDirty = true;
+	bool bStatusDirty = true;
+	bool bGameStateDirty = true;
+
+	// Source versions last pushed to the widgets (skips redundant notifications)
+	uint32 AppliedDeckVersion = MAX_uint32;
+	uint32 AppliedStatusVersion = MAX_uint32;
+	int32 AppliedTotalCheckpoints = INDEX_NONE;
+
 	/** Main widget instance (created in BeginPlay) */
 	UPROPERTY()
 	URobotRallyMainWidget* MainWidget;
 
+	// Fixed-capacity ring buffer (MAX_MESSAGES slots, allocated once); oldest at MessageHead
 	TArray<FEventMessage> Messages;
+	int32 MessageHead = 0;
+	int32 MessageCount = 0;
+
+	// i-th message counted from the oldest
+	FEventMessage& GetMessage(int32 i) { return Messages[(MessageHead + i) % MAX_MESSAGES]; }
 
 	static constexpr float MESSAGE_DURATION = 5.0f;
 	static constexpr int32 MAX_MESSAGES = 8;
@@ -2,6 +2,7 @@
 
 #include "RobotRallyPlayerState.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 ARobotRallyPlayerState::ARobotRallyPlayerState()
 {
@@ -11,18 +12,92 @@ void ARobotRallyPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME_CONDITION(ARobotRallyPlayerState, Rep_HandCards, COND_OwnerOnly);
-	DOREPLIFETIME_CONDITION(ARobotRallyPlayerState, Rep_RegisterSlots, COND_OwnerOnly);
-	DOREPLIFETIME(ARobotRallyPlayerState, Rep_Robot);
-	DOREPLIFETIME(ARobotRallyPlayerState, bIsReady);
+	// Push model: only compared after being marked dirty where they change
+	FDoRepLifetimeParams OwnerOnlyParams;
+	OwnerOnlyParams.bIsPushBased = true;
+	OwnerOnlyParams.Condition = COND_OwnerOnly;
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyPlayerState, Rep_HandCards, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyPlayerState, Rep_RegisterSlots, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyPlayerState, Rep_Robot, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ARobotRallyPlayerState, bIsReady, Params);
 }
 
 void ARobotRallyPlayerState::OnRep_HandCards()
 {
 	UE_LOG(LogTemp, Log, TEXT("PlayerState: Hand replicated (%d cards)"), Rep_HandCards.Num());
+	ResetLocalSelection();
+	NotifyCardsChanged();
 }
 
 void ARobotRallyPlayerState::OnRep_RegisterSlots()
 {
 	UE_LOG(LogTemp, Log, TEXT("PlayerState: Registers replicated (%d slots)"), Rep_RegisterSlots.Num());
+	ResetLocalSelection();
+	NotifyCardsChanged();
+}
+
+const TArray<int32>& ARobotRallyPlayerState::GetDisplayedRegisterSlots() const
+{
+	return bHasLocalSelection ? LocalRegisterSlots : Rep_RegisterSlots;
+}
+
+int32 ARobotRallyPlayerState::SelectLocalCard(int32 HandIndex)
+{
+	if (!Rep_HandCards.IsValidIndex(HandIndex)) return INDEX_NONE;
+
+	BeginLocalSelection();
+
+	if (LocalRegisterSlots.Contains(HandIndex)) return INDEX_NONE;
+
+	const int32 Register = LocalRegisterSlots.IndexOfByKey(-1);
+	if (Register == INDEX_NONE) return INDEX_NONE;
+
+	LocalRegisterSlots[Register] = HandIndex;
+	NotifyCardsChanged();
+	return Register;
+}
+
+int32 ARobotRallyPlayerState::UndoLocalCard()
+{
+	BeginLocalSelection();
+
+	for (int32 i = LocalRegisterSlots.Num() - 1; i >= 0; --i)
+	{
+		if (LocalRegisterSlots[i] != -1)
+		{
+			LocalRegisterSlots[i] = -1;
+			NotifyCardsChanged();
+			return i;
+		}
+	}
+	return INDEX_NONE;
+}
+
+void ARobotRallyPlayerState::BeginLocalSelection()
+{
+	if (bHasLocalSelection) return;
+
+	// Start from the registers the server knows about
+	LocalRegisterSlots.Init(-1, ARobotRallyGameMode::NUM_REGISTERS);
+	for (int32 i = 0; i < FMath::Min(Rep_RegisterSlots.Num(), LocalRegisterSlots.Num()); ++i)
+	{
+		LocalRegisterSlots[i] = Rep_RegisterSlots[i];
+	}
+	bHasLocalSelection = true;
+}
+
+void ARobotRallyPlayerState::ResetLocalSelection()
+{
+	LocalRegisterSlots.Reset();
+	bHasLocalSelection = false;
+}
+
+void ARobotRallyPlayerState::NotifyCardsChanged()
+{
+	++CardsVersion;
+	OnCardsChanged.Broadcast();
 }
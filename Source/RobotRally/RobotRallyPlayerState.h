@@ -9,6 +9,8 @@
 
 class ARobotPawn;
 
+DECLARE_MULTICAST_DELEGATE(FOnPlayerCardsChanged);
+
 UCLASS()
 class ROBOTRALLY_API ARobotRallyPlayerState : public APlayerState
 {
@@ -35,10 +37,40 @@ public:
 	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Game")
 	bool bIsReady = false;
 
+	// --- Owning client: registers filled locally and submitted in one RPC ---
+
+	// Registers to display: the local selection while one is in progress, else Rep_RegisterSlots
+	const TArray<int32>& GetDisplayedRegisterSlots() const;
+
+	// Put HandIndex into the first empty local register; returns that register or INDEX_NONE
+	int32 SelectLocalCard(int32 HandIndex);
+
+	// Clear the last filled local register; returns it or INDEX_NONE
+	int32 UndoLocalCard();
+
+	// Drop the local selection (new hand or registers from the server)
+	void ResetLocalSelection();
+
+	// Hand or registers changed (server: after SyncPlayerStateHand, client: on replication or local selection)
+	FOnPlayerCardsChanged OnCardsChanged;
+
+	// Bumped on every hand/register change so listeners can skip redundant updates
+	uint32 GetCardsVersion() const { return CardsVersion; }
+
+	void NotifyCardsChanged();
+
 private:
 	UFUNCTION()
 	void OnRep_HandCards();
 
 	UFUNCTION()
 	void OnRep_RegisterSlots();
+
+	uint32 CardsVersion = 0;
+
+	void BeginLocalSelection();
+
+	// Local register selection, valid while bHasLocalSelection
+	TArray<int32> LocalRegisterSlots;
+	bool bHasLocalSelection = false;
 };
@@ -0,0 +1,498 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#include "RobotRallySimCommandlet.h"
+#include "RobotRallyGameMode.h"
+#include "RallySimulator.h"
+#include "RallyPlanner.h"
+#include "RallyReplay.h"
+#include "GridManager.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace RallySim
+{
+	struct FSeat
+	{
+		ERobotControllerType Difficulty = ERobotControllerType::AI_Easy;
+		FIntVector Start = FIntVector::ZeroValue;
+		uint8 Facing = 0;
+		bool bHasStart = false;
+	};
+
+	// Shared read-only by every match
+	struct FSettings
+	{
+		FTileGrid Grid;
+		TArray<FSeat> Seats;
+		int32 MaxRounds = 200;
+		// Search nodes per Hard plan; a node count, not a time, so results don't depend on the machine
+		int32 HardNodeBudget = 20000;
+	};
+
+	struct FMatchResult
+	{
+		int32 Rounds = 0;
+		int32 Winner = INDEX_NONE;
+		bool bGameOver = false;
+
+		// Robots destroyed, by the tile they were destroyed on (indexed by ETileType)
+		TArray<int32, TInlineAllocator<8>> DeathsByTile;
+	};
+
+	static bool ParseDifficulty(const FString& Name, ERobotControllerType& OutType)
+	{
+		if (Name.EndsWith(TEXT("Easy"))) { OutType = ERobotControllerType::AI_Easy; return true; }
+		if (Name.EndsWith(TEXT("Medium"))) { OutType = ERobotControllerType::AI_Medium; return true; }
+		if (Name.EndsWith(TEXT("Hard"))) { OutType = ERobotControllerType::AI_Hard; return true; }
+		return false;
+	}
+
+	static FString GetDifficultyName(ERobotControllerType Type)
+	{
+		return StaticEnum<ERobotControllerType>()->GetNameStringByValue(static_cast<int64>(Type));
+	}
+
+	// Next free start tile: inset corners first, then any Normal tile in row order
+	static FIntVector FindStartTile(const FTileGrid& Grid, TConstArrayView<FSeat> Taken)
+	{
+		TArray<FIntVector> Candidates = {
+			FIntVector(1, 1, 0), FIntVector(Grid.Width - 2, Grid.Height - 2, 0),
+			FIntVector(1, Grid.Height - 2, 0), FIntVector(Grid.Width - 2, 1, 0) };
+		for (int32 Index = 0; Index < Grid.Tiles.Num(); ++Index)
+		{
+			Candidates.Add(Grid.FromIndex(Index));
+		}
+
+		for (const FIntVector& Tile : Candidates)
+		{
+			if (Grid.GetTileType(Tile.X, Tile.Y) != ETileType::Normal) continue;
+			if (Taken.ContainsByPredicate([&Tile](const FSeat& Seat) { return Seat.bHasStart && Seat.Start == Tile; })) continue;
+			return Tile;
+		}
+		return FIntVector::ZeroValue;
+	}
+
+	// Lives and checkpoints dominate, then health and closeness to the next checkpoint
+	static float ScoreRobot(const FRallyRobotState& Robot, const FTileGrid& Grid)
+	{
+		if (!Robot.bAlive) return -100000.0f;
+
+		float Score = Robot.Lives * 1000.0f + Robot.Checkpoint * 100.0f + Robot.Health;
+		const int32 Target = Grid.FindCheckpoint(Robot.Checkpoint + 1);
+		if (Target != INDEX_NONE)
+		{
+			const FIntVector TargetPos = Grid.FromIndex(Target);
+			Score -= FMath::Abs(TargetPos.X - Robot.X) + FMath::Abs(TargetPos.Y - Robot.Y);
+		}
+		return Score;
+	}
+
+	// Easy: random cards
+	static void PickRandom(int32 HandSize, FRandomStream& Stream, TArray<int32, TInlineAllocator<16>>& OutPicks)
+	{
+		OutPicks.Reset();
+		for (int32 i = 0; i < HandSize; ++i)
+		{
+			OutPicks.Add(i);
+		}
+		for (int32 i = OutPicks.Num() - 1; i > 0; --i)
+		{
+			OutPicks.Swap(i, Stream.RandRange(0, i));
+		}
+		OutPicks.SetNum(FMath::Min(HandSize, FRallySimulator::NUM_REGISTERS));
+	}
+
+	// Medium: per register, the card that leaves the robot best placed (others stand still)
+	static void PickGreedy(const FRallySimulator& Sim, int32 RobotIndex, TConstArrayView<FRallyCard> Hand,
+		TArray<int32, TInlineAllocator<16>>& OutPicks)
+	{
+		FRallySimulator Work(Sim, Sim.GetGrid());
+		OutPicks.Reset();
+
+		for (int32 Register = 0; Register < FRallySimulator::NUM_REGISTERS; ++Register)
+		{
+			int32 BestIndex = INDEX_NONE;
+			float BestScore = -MAX_flt;
+			for (int32 HandIndex = 0; HandIndex < Hand.Num(); ++HandIndex)
+			{
+				if (OutPicks.Contains(HandIndex)) continue;
+
+				FRallySimulator Trial(Work, Work.GetGrid());
+				Trial.ExecuteCard(RobotIndex, Hand[HandIndex]);
+				Trial.ResolveBoardElements();
+
+				const float Score = ScoreRobot(Trial.GetRobot(RobotIndex), Sim.GetGrid());
+				if (Score > BestScore)
+				{
+					BestScore = Score;
+					BestIndex = HandIndex;
+				}
+			}
+			if (BestIndex == INDEX_NONE) break;
+
+			OutPicks.Add(BestIndex);
+			Work.ExecuteCard(RobotIndex, Hand[BestIndex]);
+			Work.ResolveBoardElements();
+		}
+	}
+
+	static void ChooseProgram(const FSettings& Settings, const FRallySimulator& Sim, int32 RobotIndex,
+		TConstArrayView<FRallyCard> Hand, FRandomStream& Stream, FRallyProgram& OutProgram)
+	{
+		TArray<int32, TInlineAllocator<16>> Picks;
+
+		switch (Settings.Seats[RobotIndex].Difficulty)
+		{
+		case ERobotControllerType::AI_Hard:
+		{
+			FRallyPlanner Planner(Sim, RobotIndex);
+			const FRallyPlanResult Result = Planner.Plan(Hand, 0.0, Settings.HardNodeBudget);
+			Picks.Append(Result.HandIndices);
+			if (Picks.Num() < FRallySimulator::NUM_REGISTERS)
+			{
+				PickGreedy(Sim, RobotIndex, Hand, Picks);
+			}
+			break;
+		}
+		case ERobotControllerType::AI_Medium:
+			PickGreedy(Sim, RobotIndex, Hand, Picks);
+			break;
+		default:
+			PickRandom(Hand.Num(), Stream, Picks);
+			break;
+		}
+
+		OutProgram.Cards.Reset();
+		for (int32 HandIndex : Picks)
+		{
+			OutProgram.Cards.Add(Hand[HandIndex]);
+		}
+	}
+
+	// One match, same deal and card rules as ARobotRallyGameMode; no state shared with other matches
+	static void RunMatch(const FSettings& Settings, int32 MatchSeed, FMatchResult& OutResult)
+	{
+		const int32 NumSeats = Settings.Seats.Num();
+
+		FRallySimulator Sim(Settings.Grid, Settings.Grid.NumCheckpoints);
+		TArray<FRandomStream, TInlineAllocator<8>> AIStreams;
+		for (int32 i = 0; i < NumSeats; ++i)
+		{
+			const FSeat& Seat = Settings.Seats[i];
+			FRallyRobotState State;
+			State.X = State.RespawnX = Seat.Start.X;
+			State.Y = State.RespawnY = Seat.Start.Y;
+			State.Facing = Seat.Facing;
+			Sim.AddRobot(State);
+
+			AIStreams.Emplace(ARobotRallyGameMode::DeriveStreamSeed(MatchSeed, 2 + i));
+		}
+
+		FRandomStream DeckStream(ARobotRallyGameMode::DeriveStreamSeed(MatchSeed, 0));
+		TArray<FRobotCard> Deck;
+		TArray<FRobotCard> DiscardPile;
+		ARobotRallyGameMode::BuildStandardDeck(Deck);
+		ARobotRallyGameMode::ShuffleCards(Deck, DeckStream);
+
+		OutResult = FMatchResult();
+		OutResult.DeathsByTile.SetNumZeroed(static_cast<int32>(ETileType::Checkpoint) + 1);
+
+		TArray<FRallyCard, TInlineAllocator<16>> Hand;
+		TArray<FRobotCard> DealtCards;
+		TArray<FRallyEvent> Events;
+		FRallyProgram Program;
+
+		while (OutResult.Rounds < Settings.MaxRounds && !Sim.IsGameOver())
+		{
+			for (int32 i = 0; i < NumSeats; ++i)
+			{
+				const FRallyRobotState& Robot = Sim.GetRobot(i);
+				Program.Cards.Reset();
+
+				if (Robot.bAlive)
+				{
+					Hand.Reset();
+					const int32 HandSize = ARobotRallyGameMode::GetHandSize(Robot.Health, Robot.MaxHealth);
+					for (int32 Card = 0; Card < HandSize; ++Card)
+					{
+						if (Deck.Num() == 0)
+						{
+							if (DiscardPile.Num() == 0) break;
+							Deck = MoveTemp(DiscardPile);
+							DiscardPile.Reset();
+							ARobotRallyGameMode::ShuffleCards(Deck, DeckStream);
+						}
+						const FRobotCard Drawn = Deck.Pop();
+						Hand.Add({ Drawn.Action, Drawn.Priority });
+						DealtCards.Add(Drawn);
+					}
+
+					if (Hand.Num() >= FRallySimulator::NUM_REGISTERS)
+					{
+						ChooseProgram(Settings, Sim, i, Hand, AIStreams[i], Program);
+					}
+				}
+
+				Sim.SetProgram(i, Program);
+			}
+
+			Events.Reset();
+			Sim.ResolveRound(&Events);
+			OutResult.Rounds++;
+
+			// Hands are discarded after the round, as in the game
+			DiscardPile.Append(DealtCards);
+			DealtCards.Reset();
+
+			for (const FRallyEvent& Event : Events)
+			{
+				if (Event.Type == ERallyEventType::Destroyed)
+				{
+					OutResult.DeathsByTile[static_cast<int32>(Settings.Grid.GetTileType(Event.X, Event.Y))]++;
+				}
+			}
+		}
+
+		OutResult.bGameOver = Sim.IsGameOver();
+		OutResult.Winner = Sim.GetWinner();
+	}
+}
+
+namespace RallySim
+{
+	// Re-run a recording instantly and log how it ends; 0 on success
+	static int32 VerifyReplay(const FString& ReplayPath)
+	{
+		FRallyReplay Replay;
+		FRallyReplayResult Result;
+		FString Error;
+		if (!Replay.LoadFromFile(ReplayPath, Error) || !Replay.PlayHeadless(Result, Error))
+		{
+			UE_LOG(LogTemp, Error, TEXT("RobotRallySim: cannot replay %s: %s"), *ReplayPath, *Error);
+			return 1;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("RobotRallySim: %s (seed %d) played %d/%d rounds, %d keyframes, %s, winner %d"),
+			*ReplayPath, Replay.MatchSeed, Result.RoundsPlayed, Replay.Rounds.Num(), Result.Keyframes,
+			Result.bGameOver ? TEXT("game over") : TEXT("unfinished"), Result.Winner);
+
+		for (int32 i = 0; i < Result.FinalRobots.Num(); ++i)
+		{
+			const FRallyRobotState& Robot = Result.FinalRobots[i];
+			UE_LOG(LogTemp, Display, TEXT("  R%d: (%d, %d) facing %d, health %d/%d, lives %d, checkpoint %d, respawn (%d, %d), %s"),
+				i, Robot.X, Robot.Y, Robot.Facing, Robot.Health, Robot.MaxHealth, Robot.Lives, Robot.Checkpoint,
+				Robot.RespawnX, Robot.RespawnY, Robot.bAlive ? TEXT("alive") : TEXT("destroyed"));
+		}
+		return 0;
+	}
+}
+
+URobotRallySimCommandlet::URobotRallySimCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 URobotRallySimCommandlet::Main(const FString& Params)
+{
+	using namespace RallySim;
+
+	FSettings Settings;
+	int32 NumMatches = 1000;
+	int32 BaseSeed = 1;
+	FString ReplayPath;
+	FString BoardPath;
+	FString AIList;
+	FString OutPath = FPaths::ProjectSavedDir() / TEXT("SimStats")
+		/ FString::Printf(TEXT("%s.csv"), *FDateTime::Now().ToString());
+
+	FParse::Value(*Params, TEXT("Matches="), NumMatches);
+	FParse::Value(*Params, TEXT("Seed="), BaseSeed);
+	FParse::Value(*Params, TEXT("MaxRounds="), Settings.MaxRounds);
+	FParse::Value(*Params, TEXT("HardNodes="), Settings.HardNodeBudget);
+	Settings.HardNodeBudget = FMath::Max(1, Settings.HardNodeBudget);
+	FParse::Value(*Params, TEXT("Replay="), ReplayPath);
+	FParse::Value(*Params, TEXT("Board="), BoardPath);
+	FParse::Value(*Params, TEXT("AI="), AIList, false);
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+	const bool bSingleThreaded = FParse::Param(*Params, TEXT("SingleThreaded"));
+
+	// Replay a recording as it was played instead of running new matches
+	if (FParse::Param(*Params, TEXT("Verify")))
+	{
+		if (ReplayPath.IsEmpty())
+		{
+			UE_LOG(LogTemp, Error, TEXT("RobotRallySim: -Verify needs -Replay=<file>"));
+			return 1;
+		}
+		return VerifyReplay(ReplayPath);
+	}
+
+	NumMatches = FMath::Max(1, NumMatches);
+	Settings.MaxRounds = FMath::Max(1, Settings.MaxRounds);
+
+	// Board (and default seats) from a recorded match or a board blob
+	if (!ReplayPath.IsEmpty())
+	{
+		FRallyReplay Replay;
+		FString Error;
+		if (!Replay.LoadFromFile(ReplayPath, Error) || !Replay.BuildGrid(Settings.Grid))
+		{
+			UE_LOG(LogTemp, Error, TEXT("RobotRallySim: cannot use replay %s %s"), *ReplayPath, *Error);
+			return 1;
+		}
+
+		for (const FRallyReplayRobot& Robot : Replay.Robots)
+		{
+			FSeat& Seat = Settings.Seats.AddDefaulted_GetRef();
+			Seat.Start = FIntVector(Robot.State.X, Robot.State.Y, 0);
+			Seat.Facing = Robot.State.Facing;
+			Seat.bHasStart = true;
+
+			// Humans are stood in for by the greedy AI
+			const ERobotControllerType Type = static_cast<ERobotControllerType>(Robot.ControllerType);
+			Seat.Difficulty = Type == ERobotControllerType::Player || Type > ERobotControllerType::AI_Hard
+				? ERobotControllerType::AI_Medium : Type;
+		}
+	}
+	else if (!BoardPath.IsEmpty())
+	{
+		TArray<uint8> Blob;
+		if (!FFileHelper::LoadFileToArray(Blob, *BoardPath) || !Settings.Grid.InitFromBoardBlob(Blob))
+		{
+			UE_LOG(LogTemp, Error, TEXT("RobotRallySim: cannot read board %s"), *BoardPath);
+			return 1;
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("RobotRallySim: pass -Replay=<file> or -Board=<file>"));
+		return 1;
+	}
+
+	// -AI overrides the seats' difficulties; seats beyond the recorded ones get a free start tile
+	if (!AIList.IsEmpty())
+	{
+		TArray<FString> Names;
+		AIList.ParseIntoArray(Names, TEXT(","));
+		Settings.Seats.SetNum(Names.Num());
+
+		for (int32 i = 0; i < Names.Num(); ++i)
+		{
+			if (!ParseDifficulty(Names[i].TrimStartAndEnd(), Settings.Seats[i].Difficulty))
+			{
+				UE_LOG(LogTemp, Error, TEXT("RobotRallySim: unknown AI '%s' (Easy, Medium or Hard)"), *Names[i]);
+				return 1;
+			}
+		}
+	}
+
+	for (int32 i = 0; i < Settings.Seats.Num(); ++i)
+	{
+		FSeat& Seat = Settings.Seats[i];
+		if (!Seat.bHasStart)
+		{
+			Seat.Start = FindStartTile(Settings.Grid, MakeArrayView(Settings.Seats.GetData(), i));
+			Seat.bHasStart = true;
+		}
+	}
+
+	if (Settings.Seats.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("RobotRallySim: no seats (use -AI=Easy,Medium,...)"));
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("RobotRallySim: %d matches, %d seats, %dx%d board, seed %d"),
+		NumMatches, Settings.Seats.Num(), Settings.Grid.Width, Settings.Grid.Height, BaseSeed);
+
+	TArray<FMatchResult> Results;
+	Results.SetNum(NumMatches);
+
+	const double StartTime = FPlatformTime::Seconds();
+	ParallelFor(NumMatches, [&Settings, &Results, BaseSeed](int32 MatchIndex)
+	{
+		RunMatch(Settings, ARobotRallyGameMode::DeriveStreamSeed(BaseSeed, MatchIndex), Results[MatchIndex]);
+	}, bSingleThreaded ? EParallelForFlags::ForceSingleThread : EParallelForFlags::Unbalanced);
+	const double Seconds = FMath::Max(FPlatformTime::Seconds() - StartTime, 1e-6);
+
+	// Aggregate
+	const int32 NumSeats = Settings.Seats.Num();
+	TArray<int32> SeatWins;
+	SeatWins.SetNumZeroed(NumSeats);
+	TMap<ERobotControllerType, TPair<int32, int32>> DifficultyWins;  // seats played, wins
+	TArray<int32> DeathsByTile;
+	DeathsByTile.SetNumZeroed(static_cast<int32>(ETileType::Checkpoint) + 1);
+	int64 TotalRounds = 0;
+	int32 NoWinner = 0;
+	int32 Unfinished = 0;
+
+	for (const FMatchResult& Result : Results)
+	{
+		TotalRounds += Result.Rounds;
+		if (!Result.bGameOver) Unfinished++;
+		if (Result.Winner == INDEX_NONE) NoWinner++;
+
+		for (int32 Seat = 0; Seat < NumSeats; ++Seat)
+		{
+			TPair<int32, int32>& Entry = DifficultyWins.FindOrAdd(Settings.Seats[Seat].Difficulty);
+			Entry.Key++;
+			if (Result.Winner == Seat)
+			{
+				SeatWins[Seat]++;
+				Entry.Value++;
+			}
+		}
+
+		for (int32 Type = 0; Type < DeathsByTile.Num(); ++Type)
+		{
+			DeathsByTile[Type] += Result.DeathsByTile[Type];
+		}
+	}
+
+	// CSV: one Category,Key,Value row per statistic
+	FString Csv = TEXT("Category,Key,Value\n");
+	auto AddRow = [&Csv](const TCHAR* Category, const FString& Key, const FString& Value)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%s\n"), Category, *Key, *Value);
+		UE_LOG(LogTemp, Display, TEXT("  %s %s = %s"), Category, *Key, *Value);
+	};
+
+	AddRow(TEXT("Run"), TEXT("Matches"), FString::FromInt(NumMatches));
+	AddRow(TEXT("Run"), TEXT("Seconds"), FString::Printf(TEXT("%.3f"), Seconds));
+	AddRow(TEXT("Run"), TEXT("RoundsPerSecond"), FString::Printf(TEXT("%.1f"), TotalRounds / Seconds));
+	AddRow(TEXT("Run"), TEXT("MatchesPerSecond"), FString::Printf(TEXT("%.1f"), NumMatches / Seconds));
+	AddRow(TEXT("Match"), TEXT("AverageRounds"), FString::Printf(TEXT("%.2f"), static_cast<double>(TotalRounds) / NumMatches));
+	AddRow(TEXT("Match"), TEXT("NoWinner"), FString::FromInt(NoWinner));
+	AddRow(TEXT("Match"), TEXT("HitMaxRounds"), FString::FromInt(Unfinished));
+
+	for (int32 Seat = 0; Seat < NumSeats; ++Seat)
+	{
+		AddRow(TEXT("SeatWinRate"),
+			FString::Printf(TEXT("%d %s"), Seat, *GetDifficultyName(Settings.Seats[Seat].Difficulty)),
+			FString::Printf(TEXT("%.4f"), static_cast<double>(SeatWins[Seat]) / NumMatches));
+	}
+
+	for (const TPair<ERobotControllerType, TPair<int32, int32>>& Entry : DifficultyWins)
+	{
+		AddRow(TEXT("DifficultyWinRate"), GetDifficultyName(Entry.Key),
+			FString::Printf(TEXT("%.4f"), static_cast<double>(Entry.Value.Value) / FMath::Max(1, Entry.Value.Key)));
+	}
+
+	for (int32 Type = 0; Type < DeathsByTile.Num(); ++Type)
+	{
+		AddRow(TEXT("DeathsByTile"), StaticEnum<ETileType>()->GetNameStringByValue(Type), FString::FromInt(DeathsByTile[Type]));
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("RobotRallySim: cannot write %s"), *OutPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("RobotRallySim: wrote %s"), *OutPath);
+	return 0;
+}
@@ -0,0 +1,34 @@
+// Copyright (c) 2026 Robot Rally Team. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RobotRallySimCommandlet.generated.h"
+
+/**
+ * Plays complete AI-only matches on FRallySimulator: no world, actors, rendering or timers.
+ * Matches run in parallel, each with its own seeded streams. Writes throughput, win rates
+ * per seat and difficulty, match length and deaths by tile type as CSV.
+ *
+ * UnrealEditor-Cmd RobotRally -run=RobotRallySim (-Replay=<file> | -Board=<file>)
+ *     [-AI=Easy,Medium,Hard] [-Matches=1000] [-Seed=1] [-MaxRounds=200]
+ *     [-HardNodes=20000] [-Out=<csv>] [-SingleThreaded]
+ *
+ * -Replay takes the board and seats of a recorded match, -Board a board blob (e.g. from Saved/BoardCache).
+ *
+ * UnrealEditor-Cmd RobotRally -run=RobotRallySim -Replay=<file> -Verify
+ *
+ * -Verify re-runs the recorded match itself (FRallyReplay::PlayHeadless) and logs its rounds,
+ * keyframes, winner and final robot states.
+ */
+UCLASS()
+class ROBOTRALLY_API URobotRallySimCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	URobotRallySimCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
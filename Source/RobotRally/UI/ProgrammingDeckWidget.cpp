@@ -5,17 +5,31 @@
 #include "../RobotRallyGameMode.h"
 #include "Components/UniformGridPanel.h"
 #include "Components/HorizontalBox.h"
+#include "Components/UniformGridSlot.h"
 
 void UProgrammingDeckWidget::UpdateHandCards(const TArray<FRobotCard>& NewHandCards)
 {
 	HandCards = NewHandCards;
-	RebuildHandWidgets();
+	PatchHandWidgets();
+	PatchRegisterWidgets();
 }
 
 void UProgrammingDeckWidget::UpdateRegisterSlots(const TArray<int32>& NewRegisterSlots)
 {
 	RegisterSlots = NewRegisterSlots;
-	RebuildRegisterWidgets();
+
+	// Hand widgets show InRegister state, so they need patching too
+	PatchHandWidgets();
+	PatchRegisterWidgets();
+}
+
+void UProgrammingDeckWidget::UpdateDeck(const TArray<FRobotCard>& NewHandCards, const TArray<int32>& NewRegisterSlots)
+{
+	// Hand widgets show InRegister state, so both sides depend on the registers
+	HandCards = NewHandCards;
+	RegisterSlots = NewRegisterSlots;
+	PatchHandWidgets();
+	PatchRegisterWidgets();
 }
 
 void UProgrammingDeckWidget::OnCardSelected(int32 HandIndex)
@@ -24,6 +38,144 @@ void UProgrammingDeckWidget::OnCardSelected(int32 HandIndex)
 	// Will call RobotController->SelectCard(HandIndex) to reuse existing RPC logic
 }
 
+bool UProgrammingDeckWidget::IsHandCardInRegister(int32 HandIndex) const
+{
+	return RegisterSlots.Contains(HandIndex);
+}
+
+void UProgrammingDeckWidget::PatchHandWidgets()
+{
+	if (!HandGridPanel || !CardWidgetClass)
+	{
+		return;
+	}
+
+	const int32 NumCards = HandCards.Num();
+
+	// Hand size changed (first deal, locked cards): lay the grid out again
+	if (HandCardWidgets.Num() < NumCards || HandGridPanel->GetChildrenCount() != NumCards)
+	{
+		RebuildHandWidgets();
+		return;
+	}
+
+	// Key the slotted widgets by the card they currently show
+	TMap<int32, UCardWidget*> WidgetsByPriority;
+	for (int32 i = 0; i < NumCards; ++i)
+	{
+		if (!HandCardWidgets[i])
+		{
+			RebuildHandWidgets();
+			return;
+		}
+		WidgetsByPriority.Add(HandCardWidgets[i]->CardData.Priority, HandCardWidgets[i]);
+	}
+
+	// Cards still in hand keep their widget; new cards take over widgets whose card left
+	TArray<UCardWidget*> Slotted;
+	Slotted.SetNumZeroed(NumCards);
+	TArray<int32> NewCardIndices;
+	for (int32 i = 0; i < NumCards; ++i)
+	{
+		UCardWidget* Widget = nullptr;
+		if (WidgetsByPriority.RemoveAndCopyValue(HandCards[i].Priority, Widget))
+		{
+			Slotted[i] = Widget;
+		}
+		else
+		{
+			NewCardIndices.Add(i);
+		}
+	}
+
+	TArray<UCardWidget*> SpareWidgets;
+	WidgetsByPriority.GenerateValueArray(SpareWidgets);
+	if (SpareWidgets.Num() != NewCardIndices.Num())
+	{
+		// Duplicate keys (e.g. never-initialized widgets); fall back to a full rebuild
+		RebuildHandWidgets();
+		return;
+	}
+
+	for (int32 k = 0; k < NewCardIndices.Num(); ++k)
+	{
+		Slotted[NewCardIndices[k]] = SpareWidgets[k];
+	}
+
+	for (int32 i = 0; i < NumCards; ++i)
+	{
+		UCardWidget* CardWidget = Slotted[i];
+		const FRobotCard& Card = HandCards[i];
+
+		if (CardWidget->HandIndex != i || CardWidget->CardData.Priority != Card.Priority ||
+			CardWidget->CardData.Action != Card.Action)
+		{
+			CardWidget->SetCardData(Card, i);
+		}
+
+		// Moved card: update its grid cell in place instead of re-adding it
+		if (CardWidget != HandCardWidgets[i])
+		{
+			if (UUniformGridSlot* GridSlot = Cast<UUniformGridSlot>(CardWidget->Slot))
+			{
+				GridSlot->SetRow(i / 3);
+				GridSlot->SetColumn(i % 3);
+			}
+		}
+
+		// No-op if unchanged
+		CardWidget->SetCardState(IsHandCardInRegister(i) ? ECardWidgetState::InRegister : ECardWidgetState::Default);
+	}
+
+	for (int32 i = 0; i < NumCards; ++i)
+	{
+		HandCardWidgets[i] = Slotted[i];
+	}
+}
+
+void UProgrammingDeckWidget::PatchRegisterWidgets()
+{
+	if (!RegisterBox || !CardWidgetClass)
+	{
+		return;
+	}
+
+	const int32 NumRegisters = ARobotRallyGameMode::NUM_REGISTERS;
+	if (RegisterCardWidgets.Num() < NumRegisters || RegisterBox->GetChildrenCount() != NumRegisters)
+	{
+		RebuildRegisterWidgets();
+		return;
+	}
+
+	for (int32 RegIndex = 0; RegIndex < NumRegisters; ++RegIndex)
+	{
+		UCardWidget* CardWidget = RegisterCardWidgets[RegIndex];
+		if (!CardWidget) continue;
+
+		int32 HandIndex = (RegIndex < RegisterSlots.Num()) ? RegisterSlots[RegIndex] : -1;
+
+		if (HandIndex >= 0 && HandIndex < HandCards.Num())
+		{
+			const FRobotCard& Card = HandCards[HandIndex];
+			if (CardWidget->HandIndex != HandIndex || CardWidget->CardData.Priority != Card.Priority ||
+				CardWidget->CardData.Action != Card.Action)
+			{
+				CardWidget->SetCardData(Card, HandIndex);
+			}
+			CardWidget->SetCardState(ECardWidgetState::InRegister);
+
+			if (CardWidget->GetVisibility() != ESlateVisibility::Visible)
+			{
+				CardWidget->SetVisibility(ESlateVisibility::Visible);
+			}
+		}
+		else if (CardWidget->GetVisibility() != ESlateVisibility::Hidden)
+		{
+			CardWidget->SetVisibility(ESlateVisibility::Hidden);
+		}
+	}
+}
+
 void UProgrammingDeckWidget::RebuildHandWidgets()
 {
 	if (!HandGridPanel || !CardWidgetClass)
@@ -57,6 +57,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Deck")
 	void UpdateRegisterSlots(const TArray<int32>& NewRegisterSlots);
 
+	/**
+	 * Update hand and registers together (rebuilds each side once)
+	 * @param NewHandCards Card data array from PlayerState or GameMode
+	 * @param NewRegisterSlots Hand indices in registers (-1 = empty)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Deck")
+	void UpdateDeck(const TArray<FRobotCard>& NewHandCards, const TArray<int32>& NewRegisterSlots);
+
 	/**
 	 * Handle card selection (called by UCardWidget::OnCardClicked in Phase 7)
 	 * @param HandIndex Index of card in hand array
@@ -78,4 +86,16 @@ protected:
 
 	/** Rebuild register widgets based on current RegisterSlots array */
 	void RebuildRegisterWidgets();
+
+	/**
+	 * Patch only the hand widgets whose card or state changed. Widgets are keyed by card
+	 * priority (unique per deck card); grid slots are only rebuilt when the hand size changes.
+	 */
+	void PatchHandWidgets();
+
+	/** Patch only the register widgets whose card or visibility changed */
+	void PatchRegisterWidgets();
+
+	/** True if HandIndex is placed in any register */
+	bool IsHandCardInRegister(int32 HandIndex) const;
 };
@@ -55,31 +55,20 @@ void URobotRallyMainWidget::AddEventMessage(const FString& Message, FLinearColor
 	// Trigger Blueprint event for visual update
 	OnEventMessageAdded(Message, MessageColor);
 
-	// If EventLogBox and EventMessageWidgetClass are set, create widget
+	// If EventLogBox and EventMessageWidgetClass are set, show it in a pooled widget
 	if (EventLogBox && EventMessageWidgetClass)
 	{
-		// Create message widget
-		UUserWidget* MessageWidget = CreateWidget<UUserWidget>(GetWorld(), EventMessageWidgetClass);
+		UUserWidget* MessageWidget = AcquireEventMessageWidget();
 		if (MessageWidget)
 		{
-			// Add to event log
-			EventLogBox->AddChild(MessageWidget);
-
-			// Trim old messages if limit exceeded
-			TrimEventLog();
+			EventMessageExpireTimes.Last() = GetWorld()->GetTimeSeconds() + EventMessageDuration;
+			MessageWidget->SetVisibility(EventMessageVisibility);
+			OnEventMessageWidgetAssigned(MessageWidget, Message, MessageColor);
 
-			// Set up auto-removal timer
-			FTimerHandle RemovalTimer;
-			FTimerDelegate RemovalDelegate;
-			RemovalDelegate.BindLambda([MessageWidget]()
+			if (!GetWorld()->GetTimerManager().IsTimerActive(EventLogExpiryTimer))
 			{
-				if (MessageWidget && MessageWidget->IsValidLowLevel())
-				{
-					MessageWidget->RemoveFromParent();
-				}
-			});
-
-			GetWorld()->GetTimerManager().SetTimer(RemovalTimer, RemovalDelegate, EventMessageDuration, false);
+				ExpireEventMessages();
+			}
 		}
 	}
 }
@@ -126,23 +115,73 @@ FString URobotRallyMainWidget::GetMessageTypeIcon(EEventMessageType MessageType)
 	}
 }
 
-void URobotRallyMainWidget::TrimEventLog()
+UUserWidget* URobotRallyMainWidget::AcquireEventMessageWidget()
 {
-	if (!EventLogBox)
+	// Grow the pool up to capacity
+	if (EventMessageWidgets.Num() < FMath::Max(1, MaxEventMessages))
+	{
+		UUserWidget* MessageWidget = CreateWidget<UUserWidget>(GetWorld(), EventMessageWidgetClass);
+		if (!MessageWidget)
+		{
+			return nullptr;
+		}
+
+		EventMessageVisibility = MessageWidget->GetVisibility();
+		EventLogBox->AddChild(MessageWidget);
+		EventMessageWidgets.Add(MessageWidget);
+		EventMessageExpireTimes.Add(0.0);
+		return MessageWidget;
+	}
+
+	// Recycle the oldest (top) widget as the newest (bottom) one; ShiftChild keeps its slot
+	UUserWidget* Oldest = EventMessageWidgets[0];
+	for (int32 i = 1; i < EventMessageWidgets.Num(); ++i)
+	{
+		EventMessageWidgets[i - 1] = EventMessageWidgets[i];
+		EventMessageExpireTimes[i - 1] = EventMessageExpireTimes[i];
+	}
+	EventMessageWidgets.Last() = Oldest;
+
+	if (Oldest)
+	{
+		EventLogBox->ShiftChild(EventLogBox->GetChildrenCount() - 1, Oldest);
+	}
+	return Oldest;
+}
+
+void URobotRallyMainWidget::ExpireEventMessages()
+{
+	UWorld* World = GetWorld();
+	if (!World)
 	{
 		return;
 	}
 
-	// Remove oldest messages if limit exceeded
-	int32 ChildCount = EventLogBox->GetChildrenCount();
-	while (ChildCount > MaxEventMessages)
+	const double Now = World->GetTimeSeconds();
+	double NextExpiry = TNumericLimits<double>::Max();
+
+	for (int32 i = 0; i < EventMessageWidgets.Num(); ++i)
 	{
-		UWidget* OldestMessage = EventLogBox->GetChildAt(0);
-		if (OldestMessage)
+		UUserWidget* MessageWidget = EventMessageWidgets[i];
+		if (!MessageWidget || MessageWidget->GetVisibility() == ESlateVisibility::Collapsed)
 		{
-			OldestMessage->RemoveFromParent();
+			continue;
 		}
-		ChildCount = EventLogBox->GetChildrenCount();
+
+		if (EventMessageExpireTimes[i] <= Now)
+		{
+			MessageWidget->SetVisibility(ESlateVisibility::Collapsed);
+		}
+		else
+		{
+			NextExpiry = FMath::Min(NextExpiry, EventMessageExpireTimes[i]);
+		}
+	}
+
+	if (NextExpiry < TNumericLimits<double>::Max())
+	{
+		World->GetTimerManager().SetTimer(EventLogExpiryTimer, this, &URobotRallyMainWidget::ExpireEventMessages,
+			static_cast<float>(NextExpiry - Now), false);
 	}
 }
 
@@ -143,6 +143,13 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
 	void OnEventMessageAdded(const FString& Message, FLinearColor MessageColor);
 
+	/**
+	 * Blueprint event triggered when a pooled event message widget is (re)assigned a message
+	 * Implement in WBP_MainHUD to set the widget's text and color
+	 */
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void OnEventMessageWidgetAssigned(UUserWidget* MessageWidget, const FString& Message, FLinearColor MessageColor);
+
 	/**
 	 * Update programming deck visibility based on game state
 	 * Show in Programming state, hide in Executing/GameOver
@@ -221,6 +228,25 @@ private:
 	/** Cached game state for helper methods */
 	EGameState CachedGameState = EGameState::Programming;
 
-	/** Remove oldest message from event log if limit exceeded */
-	void TrimEventLog();
+	/**
+	 * Event log widget pool, in display order (oldest at top). Grows to MaxEventMessages,
+	 * then the oldest widget is recycled and moved to the bottom.
+	 */
+	UPROPERTY()
+	TArray<UUserWidget*> EventMessageWidgets;
+
+	/** World time each pooled widget's message expires, parallel to EventMessageWidgets */
+	TArray<double> EventMessageExpireTimes;
+
+	/** Visibility the message widgets are created with (restored when recycled) */
+	ESlateVisibility EventMessageVisibility = ESlateVisibility::SelfHitTestInvisible;
+
+	/** Single timer for the next message expiry */
+	FTimerHandle EventLogExpiryTimer;
+
+	/** Get a widget for a new message, creating one only while the pool is below capacity */
+	UUserWidget* AcquireEventMessageWidget();
+
+	/** Hide expired messages and schedule the next expiry */
+	void ExpireEventMessages();
 };